@@ -0,0 +1,52 @@
+#include "AliasTable.h"
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  ///////////////////////////////////////////////////////////
+  ///Scale weights to mean 1, then pair each entry below 1 (small)
+  ///with one above 1 (large) which gives it the remainder
+  void AliasTable::Build(const std::vector<double>& weights){
+    const size_t n=weights.size();
+    _weights=weights;
+    _sum=0;
+    for(auto w:weights){
+      if(w<0 || std::isnan(w)){
+	std::cerr<<"AliasTable::Build weights must be positive, exiting..."<<std::endl;
+	exit(0);
+      }
+      _sum+=w;
+    }
+    if(n==0 || _sum<=0){
+      std::cerr<<"AliasTable::Build no positive weights, exiting..."<<std::endl;
+      exit(0);
+    }
+
+    _threshold.resize(n);
+    _alias.resize(n);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for(size_t i=0;i<n;++i){
+      _threshold[i]=weights[i]*n/_sum;
+      _alias[i]=i;
+      if(_threshold[i]<1) small.push_back(i);
+      else large.push_back(i);
+    }
+
+    while(small.empty()==false && large.empty()==false){
+      auto is=small.back(); small.pop_back();
+      auto il=large.back();
+      _alias[is]=il;
+      _threshold[il]-=1-_threshold[is];
+      if(_threshold[il]<1){
+	large.pop_back();
+	small.push_back(il);
+      }
+    }
+    //left overs are 1 up to rounding
+    for(auto i:large) _threshold[i]=1;
+    for(auto i:small) _threshold[i]=1;
+  }
+
+}
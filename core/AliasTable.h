@@ -0,0 +1,53 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		AliasTable
+///Description:
+///             Sample an index i with probability weights[i]/sum
+///             in constant time (Walker alias method, Vose's build)
+///             Each entry has a threshold and an alias, one uniform
+///             number picks the entry and decides between the two
+///             e.g.
+///             AliasTable table(cellWeights);
+///             auto icell = table.Sample(rng());
+#pragma once
+
+#include "RandomEngine.h"
+#include <cstdint>
+#include <vector>
+
+namespace elSpectro{
+
+  class AliasTable{
+
+  public:
+
+    AliasTable()=default;
+    explicit AliasTable(const std::vector<double>& weights){Build(weights);}
+
+    //weights must be >=0 with a positive sum
+    void Build(const std::vector<double>& weights);
+
+    size_t Sample(RandomEngine& random) const noexcept{
+      double u = random.Uniform()*_threshold.size();
+      size_t i = static_cast<size_t>(u);
+      if(i>=_threshold.size()) i=_threshold.size()-1;
+      return (u-i) < _threshold[i] ? i : _alias[i];
+    }
+
+    //weights[i]/sum
+    double Probability(size_t i)const noexcept{return _weights[i]/_sum;}
+    double Weight(size_t i)const noexcept{return _weights[i];}
+    double Sum()const noexcept{return _sum;}
+    size_t Size()const noexcept{return _threshold.size();}
+    bool Empty()const noexcept{return _threshold.empty();}
+
+  private:
+
+    std::vector<double> _weights;
+    std::vector<double> _threshold;
+    std::vector<uint32_t> _alias;
+    double _sum={0};
+
+  };
+
+}//namespace elSpectro
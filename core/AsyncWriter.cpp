@@ -0,0 +1,95 @@
+#include "AsyncWriter.h"
+#include <chrono>
+#include <iostream>
+
+namespace elSpectro{
+
+  namespace{
+    //spin briefly then sleep so an idle thread does not take a core
+    void backOff(int& nidle){
+      if(++nidle<64) std::this_thread::yield();
+      else std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  ///Constructor, writer thread starts with first event
+  AsyncWriter::AsyncWriter(Writer* writer,size_t nslots):
+    _writer{writer},
+    _ring{nslots}
+  {
+    if(_writer.get()==nullptr){
+      std::cerr<<"AsyncWriter::AsyncWriter no writer given, exiting..."<<std::endl;
+      exit(0);
+    }
+    _filename=_writer->FileName();
+  }
+
+  AsyncWriter::~AsyncWriter(){
+    End();
+  }
+  ///////////////////////////////////////////////////////////////
+  void AsyncWriter::Init(){
+    _writer->Init();
+  }
+  ///////////////////////////////////////////////////////////////
+  ///Copy this event into the next free slot,
+  ///waiting for the writer thread if there is none
+  void AsyncWriter::FillAnEvent(const EventRecord& event){
+    if(_thread.joinable()==false) StartThread();
+    auto* slot=_ring.WriteSlot();
+    if(slot==nullptr){
+      ++_nWaits;
+      int nidle=0;
+      while( (slot=_ring.WriteSlot())==nullptr ) backOff(nidle);
+    }
+    *slot=event; //vectors keep their capacity
+    _ring.Publish();
+  }
+  ///////////////////////////////////////////////////////////////
+  void AsyncWriter::StartThread(){
+    _stop.store(false);
+    _thread=std::thread(&AsyncWriter::Drain,this);
+  }
+  ///////////////////////////////////////////////////////////////
+  ///Writer thread, format and write events until stopped and empty
+  void AsyncWriter::Drain(){
+    int nidle=0;
+    while(true){
+      //check before reading so no event published before stop is missed
+      bool stop=_stop.load(std::memory_order_acquire);
+      if(auto* event=_ring.ReadSlot()){
+	_writer->FillAnEvent(*event);
+	_writer->Write();
+	_ring.Release();
+	nidle=0;
+	continue;
+      }
+      if(stop) break;
+      backOff(nidle);
+    }
+  }
+  ///////////////////////////////////////////////////////////////
+  void AsyncWriter::StopThread(){
+    if(_thread.joinable()==false) return;
+    _stop.store(true,std::memory_order_release);
+    _thread.join();
+  }
+  ///////////////////////////////////////////////////////////////
+  ///Write all queued events then close the file
+  void AsyncWriter::End(){
+    StopThread();
+    _writer->End();
+  }
+  ///////////////////////////////////////////////////////////////
+  void AsyncWriter::Flush(){
+    StopThread();
+    _writer->Flush();
+  }
+  ///////////////////////////////////////////////////////////////
+  void AsyncWriter::OpenShard(int ishard){
+    StopThread();
+    _writer->OpenShard(ishard);
+    _filename=_writer->FileName();
+  }
+
+}
@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		AsyncWriter
+///Description:
+///             Run any Writer on its own thread
+///             FillAnEvent() copies the EventRecord into a RingBuffer of
+///             EventRecords, a writer thread formats and writes them
+///             with the wrapped writer. If the writer thread falls
+///             behind the generator waits for a free slot (backpressure)
+///             End() writes all queued events before closing
+///             e.g. writer(new AsyncWriter{new HepMC3Writer{"out.txt"}});
+
+#pragma once
+
+#include "Writer.h"
+#include "RingBuffer.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace elSpectro{
+
+  class AsyncWriter : public Writer {
+
+   public:
+     //takes ownership of writer
+     AsyncWriter(Writer* writer,size_t nslots=1024);
+     ~AsyncWriter() final;
+     AsyncWriter(const AsyncWriter& other)=delete;
+     AsyncWriter(AsyncWriter&&)=delete;
+     AsyncWriter& operator=(const AsyncWriter& other)=delete;
+     AsyncWriter& operator=(AsyncWriter&& other)=delete;
+
+     void WriteHeader() final{};
+     using Writer::FillAnEvent;
+     void FillAnEvent(const EventRecord& event) final;
+     void Write() final{}; //done on writer thread
+     void End() final;
+     void Init() final;
+
+     //waits for queued events, stops the writer thread
+     //which restarts with the next event
+     void Flush() final;
+     void OpenShard(int ishard) final;
+
+     void MergeShards(const std::vector<std::string>& shards,
+		      const std::string& merged) const final{
+       _writer->MergeShards(shards,merged);
+     }
+
+     const Writer* GetWriter()const noexcept{return _writer.get();}
+     //number of times the generator waited for the writer thread
+     long NWaits()const noexcept{return _nWaits;}
+
+   private:
+
+     void StartThread();
+     void StopThread();
+     void Drain();
+
+     std::unique_ptr<Writer> _writer;
+     RingBuffer<EventRecord> _ring;//!
+     std::thread _thread;//!
+     std::atomic<bool> _stop={false};//!
+     long _nWaits={0};
+
+     ClassDef(elSpectro::AsyncWriter,1); //class AsyncWriter
+   };
+
+
+}
@@ -34,6 +34,7 @@ namespace elSpectro{
       if(tf1!=nullptr){
 	//	tf1->GetTF1().SetParameter(0,ebeam);
 	tf1->GetTF1().SetRange(emin/ebeam,emax/ebeam);
+	tf1->UpdateTable();
       }
    
     };
@@ -42,6 +43,7 @@ namespace elSpectro{
       if(tf1!=nullptr){
 	//	tf1->GetTF1().SetParameter(0,ebeam);
 	tf1->GetTF1().SetRange(emin/ebeam,emax/ebeam);
+	tf1->UpdateTable();
       }
    
     };
@@ -58,6 +58,13 @@ namespace elSpectro{
     }
     
     virtual bool RegenerateOnFail() const noexcept =0;
+    //called once Intensity() has been accepted, before the products
+    //decay, for work only accepted decays need e.g. SDMEs
+    virtual void PostAccept() const {}
+    //cheap bounds lower <= Intensity() <= upper for the current product
+    //vectors, false if not known. If true the model must be left ready
+    //for PostAccept() as if Intensity() had been called
+    virtual bool IntensityBounds(double& lower,double& upper) const {return false;}
     virtual bool HasAngularDistribution(){return true; }
     
     bool CheckThreshold() const{
@@ -1,8 +1,10 @@
 #include "DecayModelQ2W.h"
 #include "DecayingParticle.h"
 #include "FunctionsForElectronScattering.h"
+#include "Manager.h"
 #include <TDatabasePDG.h>
 #include "TFile.h"
+#include <algorithm>
 
 
 namespace elSpectro{
@@ -76,6 +78,7 @@ namespace elSpectro{
       
  
       FindExcitationSpectra();
+      if(_useQ2Envelope) FindQ2Envelope();
   
   }
   
@@ -106,13 +109,25 @@ namespace elSpectro{
     _photonPol.SetEpsilon(epsilon);
     _photonPol.SetDelta(delta);
  
-    //Get envelope weight from integrated cross section
-    double weight=_Wrealphoto_Dist->GetWeightFor( W  );
-      
     if(getQ2() > 2*p4tar.M()*_gamma.E()){
       std::cout<<"Q2 above max how ? "<<getQ2()<<" 2Mmu "<<2*p4tar.M()*_gamma.E() <<" W "<<W<<std::endl;
       exit(0);
     }
+
+    if(_useQ2Envelope){
+      //envelope includes finite Q2 phase space, DecayModelst::Intensity
+      //divides by envelope/_stMax so only the difference from
+      //the bin maximum is left to accept
+      auto ix=std::clamp(_WQ2Envelope.GetXaxis()->FindFixBin(W),1,_WQ2Envelope.GetNbinsX());
+      auto iy=std::clamp(_WQ2Envelope.GetYaxis()->FindFixBin(getQ2()),1,_WQ2Envelope.GetNbinsY());
+      auto envelope=_WQ2Envelope.GetBinContent(ix,iy);
+      _prodInfo->_sWeight= envelope>0 ? envelope/_stMax : 1;
+      //Q2 dependence of cross section
+      return envelope/_envelopeNorm*Q2H1Rho();
+    }
+    
+    //Get envelope weight from integrated cross section
+    double weight=_Wrealphoto_Dist->GetWeightFor( W  );
     
  
     //  std::cout<<" Q2 DEPENDENECE "<<PhaseSpaceFactorToQ2eq0(W,p4tar.M() )<<"      "<<getQ2()<<" 2Mmu "<<2*p4tar.M()*_gamma.E() <<" W "<<W<<"             PDKs     "<< kine::PDK(W, -getQ2(),p4tar.M())<<" "<< kine::PDK(W, getQ2(),p4tar.M())<<" "<< kine::PDK(W, 0 ,p4tar.M())<<" "<<std::endl;
@@ -161,33 +176,102 @@ namespace elSpectro{
     TH1D histpeak("Wdisthigh","Wdisthigh",400,_threshold,maxW);
     double minMesonMass=-1;
     if( ( mesonBaryon=dynamic_cast<DecayModelst*>(GetGammaN()->Model())) != nullptr){
-      //check for low mass meson limits
+      auto& cache=Manager::Instance().Cache();
+      InitCache::context_t context{_threshold,maxW,_prodInfo->_target->M(),
+	  meson->PdgMass(),meson->MinimumMassPossible(),gNprods[1]->PdgMass()};
+      TH1D hist("Wdist","Wdist",400,_threshold,maxW);
+      if(cache.Get("DecayModelQ2W::Wdist/"+mesonBaryon->GetName(),context,hist)==false){
+	//check for low mass meson limits
+	if(dynamic_cast<DecayingParticle*>(meson)){ //meson
+	  dynamic_cast<DecayingParticle*>(meson)->TakeMinimumMass();//to get threshold behaviour
+	  minMesonMass=meson->Mass();
+	  mesonBaryon->HistMaxXSection(histlow);
+	  //back to PDg mass if exists
+	  if(meson->PdgMass()>minMesonMass)
+	    dynamic_cast<DecayingParticle*>(meson)->TakePdgMass();
+
+	}
+	//now for PDG mass
+	//only needs to be done if meson does not decay
+	//or pdg mass is different from minMesonMass (possible if !=0)
+	if(meson->PdgMass()!=minMesonMass){
+	  mesonBaryon->HistMaxXSection(histpeak);
+	}
+	hist = HistFromLargestBinContents(histpeak,histlow);
+	hist.SetName("Wdist");
+	cache.Put("DecayModelQ2W::Wdist/"+mesonBaryon->GetName(),context,hist);
+      }
+      std::cout<<"DecayModelQ2W::FindExcitationSpectra()  result   "<<hist.GetMaximum()<<" "<<hist.GetBinCenter(hist.GetMaximumBin())<<" "<<hist.GetNbinsX()<<std::endl;
+
+        
+     _Wrealphoto_Dist.reset( new DistTH1(hist) );
+    }
+    else{
+      std::cerr<<"DecayModelQ2W::FindExcitationSpectra()Need a DecayModelst"<<std::endl;
+      exit(0);
+    }
+  }
+    
+  
+  ////////////////////////////////////////////////////////
+  ///Q2 bins are logarithmic from 1E-3 GeV^2 (the first bin starts
+  ///at 0) up to s-M^2, W bins as FindExcitationSpectra
+  void DecayModelQ2W::FindQ2Envelope(){
+    double maxW = _prodInfo->_Wmax;
+    auto targetM = _prodInfo->_target->M();
+    double maxQ2 = ( *(_prodInfo->_target) + *(_prodInfo->_ebeam) ).M2() - targetM*targetM;
+    
+    const int NbinsW=200;
+    const int NbinsQ2=24;
+    double minQ2=std::min(1E-3,maxQ2/1E3);
+    std::vector<double> Q2edges(NbinsQ2+1,0.);
+    for(int i=1;i<=NbinsQ2;++i)
+      Q2edges[i]=minQ2*TMath::Power(maxQ2/minQ2,double(i-1)/(NbinsQ2-1));
+
+    std::cout<<"DecayModelQ2W::FindQ2Envelope generating max cross section @W,Q2, may take some time... "<<std::endl;
+    auto gNprods=dynamic_cast<DecayingParticle*>(_gstarNuc)->Model()->Products();
+    auto meson=gNprods[0];
+    auto mesonBaryon = dynamic_cast<DecayModelst*>(GetGammaN()->Model());
+    
+    TH2D histlow("WQ2distlow","WQ2distlow",NbinsW,_threshold,maxW,NbinsQ2,Q2edges.data());
+    TH2D histpeak("WQ2disthigh","WQ2disthigh",NbinsW,_threshold,maxW,NbinsQ2,Q2edges.data());
+    _WQ2Envelope=TH2D("WQ2dist","WQ2dist",NbinsW,_threshold,maxW,NbinsQ2,Q2edges.data());
+    _WQ2Envelope.SetDirectory(nullptr);
+    
+    auto& cache=Manager::Instance().Cache();
+    InitCache::context_t context{_threshold,maxW,maxQ2,targetM,
+	meson->PdgMass(),meson->MinimumMassPossible(),gNprods[1]->PdgMass()};
+    if(cache.Get("DecayModelQ2W::WQ2dist/"+mesonBaryon->GetName(),context,_WQ2Envelope)==false){
+      double minMesonMass=-1;
       if(dynamic_cast<DecayingParticle*>(meson)){ //meson
 	dynamic_cast<DecayingParticle*>(meson)->TakeMinimumMass();//to get threshold behaviour
 	minMesonMass=meson->Mass();
- 	mesonBaryon->HistMaxXSection(histlow);
-	//back to PDg mass if exists
+	mesonBaryon->HistMaxXSection(histlow);
 	if(meson->PdgMass()>minMesonMass)
 	  dynamic_cast<DecayingParticle*>(meson)->TakePdgMass();
-
       }
-      //now for PDG mass
-      //only needs to be done if meson does not decay
-      //or pdg mass is different from minMesonMass (possible if !=0)
       if(meson->PdgMass()!=minMesonMass){
 	mesonBaryon->HistMaxXSection(histpeak);
       }
-      auto hist = HistFromLargestBinContents(histpeak,histlow);
-      std::cout<<"DecayModelQ2W::FindExcitationSpectra()  result   "<<hist.GetMaximum()<<" "<<hist.GetBinCenter(hist.GetMaximumBin())<<" "<<hist.GetNbinsX()<<std::endl;
-      hist.SetName("Wdist");
+      _WQ2Envelope = HistFromLargestBinContents(histpeak,histlow);
+      _WQ2Envelope.SetName("WQ2dist");
+      _WQ2Envelope.SetDirectory(nullptr);
+      cache.Put("DecayModelQ2W::WQ2dist/"+mesonBaryon->GetName(),context,_WQ2Envelope);
+    }
 
-        
-     _Wrealphoto_Dist.reset( new DistTH1(hist) );
+    _stMax = mesonBaryon->MaxIntensity();
+    //Q2H1Rho falls with Q2 so is largest at the low edge
+    _envelopeNorm=0;
+    for(int iy=1;iy<=_WQ2Envelope.GetNbinsY();iy++){
+      auto rho=Q2H1Rho(_WQ2Envelope.GetYaxis()->GetBinLowEdge(iy));
+      for(int ix=1;ix<=_WQ2Envelope.GetNbinsX();ix++)
+	_envelopeNorm=std::max(_envelopeNorm,_WQ2Envelope.GetBinContent(ix,iy)*rho);
     }
-    else{
-      std::cerr<<"DecayModelQ2W::FindExcitationSpectra()Need a DecayModelst"<<std::endl;
+    if(_envelopeNorm<=0){
+      std::cerr<<"DecayModelQ2W::FindQ2Envelope() no cross section found, exiting..."<<std::endl;
       exit(0);
     }
+    std::cout<<"DecayModelQ2W::FindQ2Envelope() result   "<<_WQ2Envelope.GetMaximum()<<" for DecayModelst max "<<_stMax<<" Q2 up to "<<maxQ2<<std::endl;
   }
     
   
@@ -217,4 +301,27 @@ namespace elSpectro{
       return hist;
    }
   
+  ///As the TH1D version, each Q2 row separately
+  ///with a margin of 5% of the row maximum
+  TH2D HistFromLargestBinContents(const TH2D& h1,const TH2D& h2){
+      auto hist= TH2D{h1};
+      for(int iy=1;iy<=hist.GetNbinsY();iy++){
+	double maxVal=0;
+	for(int ix=1;ix<=hist.GetNbinsX();ix++)
+	  maxVal=std::max({maxVal,h1.GetBinContent(ix,iy),h2.GetBinContent(ix,iy)});
+	double max_so_far=0.;
+	for(int ix=1;ix<=hist.GetNbinsX();ix++){
+	  auto val = std::max(h1.GetBinContent(ix,iy),h2.GetBinContent(ix,iy));
+	  if(val<max_so_far){
+	    hist.SetBinContent(ix,iy,max_so_far );
+	  }
+	  else{
+	    max_so_far = val + 0.05*maxVal;
+	    hist.SetBinContent(ix,iy,val + 0.05*maxVal);
+	  }
+	}
+      }
+      return hist;
+   }
+  
 }
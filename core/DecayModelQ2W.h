@@ -7,6 +7,11 @@
 ///             1) list of Particle products
 ///             2) Intensity function dependent on Q2 and W
 ///
+///            Events are proposed from an envelope of the maximum cross
+///            section in bins of W and Q2, so the finite Q2 phase space
+///            is followed. UseQ2Envelope(false) before PostInit reverts
+///            to the W only envelope from real photons
+///
 ///            Note derived classes should include a constructor to initialise
 ///            DecayModelQ2W( particle_ptrs , const std::vector<int> pdgs );
 #pragma once
@@ -19,10 +24,12 @@
 #include "DistTH1.h"
 #include "DecayModelst.h"
 #include <TH1D.h>
+#include <TH2D.h>
 
 namespace elSpectro{
 
   static TH1D HistFromLargestBinContents(const TH1D& h1,const TH1D& h2);
+  static TH2D HistFromLargestBinContents(const TH2D& h1,const TH2D& h2);
   
   class DecayModelQ2W : public DecayModel {
 
@@ -66,10 +73,14 @@ namespace elSpectro{
     }
     
     void FindExcitationSpectra();
+    void FindQ2Envelope();
     DistTH1* GetApproxWDist() const {return _Wrealphoto_Dist.get();}
+    const TH2D& GetWQ2Envelope() const noexcept{return _WQ2Envelope;}
+    void UseQ2Envelope(bool use=true){_useQ2Envelope=use;}
     //Q2 dependence from The H1 Collaboration: Elastic electroproduction of ρ mesons at HERA eqn 49 https://link.springer.com/content/pdf/10.1007/s100520000150.pdf
     constexpr double Q2H1RhoAt0() const  noexcept {return 3.0610097;}//1./TMath::Power((0.77549000*0.77549000),2.2); 
-    double Q2H1Rho() const noexcept {return 1./TMath::Power((getQ2() + 0.77549000*0.77549000),2.2)/Q2H1RhoAt0(); }
+    double Q2H1Rho() const noexcept {return Q2H1Rho(getQ2()); }
+    double Q2H1Rho(double Q2) const noexcept {return 1./TMath::Power((Q2 + 0.77549000*0.77549000),2.2)/Q2H1RhoAt0(); }
 
 
     double dsigma() const override { return  dynamic_cast<DecayingParticle*>(_gstarNuc)->Model()->dsigma();}// * Q2 factor }
@@ -105,6 +116,10 @@ namespace elSpectro{
 
     TH1D _hWPhaseSpace;
     std::unique_ptr<DistTH1> _Wrealphoto_Dist;
+    TH2D _WQ2Envelope;
+    double _envelopeNorm={1}; //largest envelope*Q2H1Rho
+    double _stMax={1}; //normalisation of DecayModelst::Intensity
+    bool _useQ2Envelope={true};
 
     ClassDefOverride(elSpectro::DecayModelQ2W,1); //class DecayModelQ2W
     
@@ -1,6 +1,7 @@
 #include "DecayModelW.h"
 #include "DecayingParticle.h"
 #include "FunctionsForElectronScattering.h"
+#include "Manager.h"
 #include <TDatabasePDG.h>
 #include "TFile.h"
 
@@ -119,25 +120,32 @@ namespace elSpectro{
     TH1D histpeak("Wdisthigh","Wdisthigh",400,_threshold,maxW);
     double minMesonMass=-1;
     if( ( mesonBaryon=dynamic_cast<DecayModelst*>(GetGammaN()->Model())) != nullptr){
-      //check for low mass meson limits
-      if(dynamic_cast<DecayingParticle*>(meson)){ //meson
-	dynamic_cast<DecayingParticle*>(meson)->TakeMinimumMass();//to get threshold behaviour
-	minMesonMass=meson->Mass();
- 	mesonBaryon->HistMaxXSection(histlow);
-	//back to PDg mass if exists
-	if(meson->PdgMass()>minMesonMass)
-	  dynamic_cast<DecayingParticle*>(meson)->TakePdgMass();
+      auto& cache=Manager::Instance().Cache();
+      InitCache::context_t context{_threshold,maxW,_prodInfo->_target->M(),
+	  meson->PdgMass(),meson->MinimumMassPossible(),gNprods[1]->PdgMass()};
+      TH1D hist("Wdist","Wdist",400,_threshold,maxW);
+      if(cache.Get("DecayModelW::Wdist/"+mesonBaryon->GetName(),context,hist)==false){
+	//check for low mass meson limits
+	if(dynamic_cast<DecayingParticle*>(meson)){ //meson
+	  dynamic_cast<DecayingParticle*>(meson)->TakeMinimumMass();//to get threshold behaviour
+	  minMesonMass=meson->Mass();
+	  mesonBaryon->HistMaxXSection(histlow);
+	  //back to PDg mass if exists
+	  if(meson->PdgMass()>minMesonMass)
+	    dynamic_cast<DecayingParticle*>(meson)->TakePdgMass();
 
+	}
+	//now for PDG mass
+	//only needs to be done if meson does not decay
+	//or pdg mass is different from minMesonMass (possible if !=0)
+	if(meson->PdgMass()!=minMesonMass){
+	  mesonBaryon->HistMaxXSection(histpeak);
+	}
+	hist = HistFromLargestBinContents(histpeak,histlow);
+	hist.SetName("Wdist");
+	cache.Put("DecayModelW::Wdist/"+mesonBaryon->GetName(),context,hist);
       }
-      //now for PDG mass
-      //only needs to be done if meson does not decay
-      //or pdg mass is different from minMesonMass (possible if !=0)
-      if(meson->PdgMass()!=minMesonMass){
-	mesonBaryon->HistMaxXSection(histpeak);
-      }
-      auto hist = HistFromLargestBinContents(histpeak,histlow);
       std::cout<<"DecayModelW::FindExcitationSpectra()  result   "<<hist.GetMaximum()<<" "<<hist.GetBinCenter(hist.GetMaximumBin())<<" "<<hist.GetNbinsX()<<std::endl;
-      hist.SetName("Wdist");
 
         
      _Wrealphoto_Dist.reset( new DistTH1(hist) );
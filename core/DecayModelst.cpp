@@ -1,6 +1,9 @@
 #include "DecayModelst.h"
 #include "SDMEDecay.h"
 #include "FunctionsForGenvector.h"
+#include "FunctionsForMaximisation.h"
+#include "FunctionsForThreads.h"
+#include "Manager.h"
 #include <TDatabasePDG.h>
 #include <Math/GSLIntegrator.h>
 #include <Math/IntegrationTypes.h>
@@ -8,8 +11,133 @@
 #include <Math/Minimizer.h>
 #include <Math/Factory.h>
 #include <TRandom3.h>
+#include <algorithm>
+#include <cmath>
 
 namespace elSpectro{
+
+  namespace{
+    //kinematics of a scan running on this thread
+    struct ScanState{
+      const DecayModelst* _model={nullptr};
+      DecayModelst::STKinematics* _kin={nullptr};
+    };
+    thread_local ScanState scanState;
+
+    //use kin for model on this thread while in scope
+    class ScanKinematics{
+    public:
+      ScanKinematics(const DecayModelst* model,DecayModelst::STKinematics& kin):
+	_previous{scanState}{
+	scanState=ScanState{model,&kin};
+      }
+      ~ScanKinematics(){scanState=_previous;}
+    private:
+      ScanState _previous;
+    };
+
+    //Upper bound on f between a and b
+    //start with ninit intervals and bisect those where f changes by
+    //more than tol of the largest value so far, up to maxDepth times
+    //f in a final interval is limited by lines from its ends with the
+    //largest slope of it and its neighbours, which also catches a
+    //peak falling between two points
+    template<typename F>
+    double adaptiveMax(F f,double a,double b,int ninit=32,double tol=0.02,int maxDepth=4){
+      struct Interval{double _a; double _b; double _fa; double _fb; int _depth;};
+      auto eval=[&f](double x){
+	auto val=f(x);
+	return std::isnan(val) ? 0. : val;
+      };
+
+      std::vector<Interval> todo;
+      double step=(b-a)/ninit;
+      double fa=eval(a);
+      double fmax=fa;
+      for(int i=0;i<ninit;++i){
+	double xa=a+i*step;
+	double xb= i==ninit-1 ? b : xa+step;
+	double fb=eval(xb);
+	todo.push_back({xa,xb,fa,fb,0});
+	fmax=std::max(fmax,fb);
+	fa=fb;
+      }
+
+      std::vector<Interval> leaves;
+      while(todo.empty()==false){
+	auto iv=todo.back();
+	todo.pop_back();
+	if(iv._depth<maxDepth && std::abs(iv._fa-iv._fb)>tol*fmax){
+	  double mid=(iv._a+iv._b)/2;
+	  double fm=eval(mid);
+	  fmax=std::max(fmax,fm);
+	  todo.push_back({iv._a,mid,iv._fa,fm,iv._depth+1});
+	  todo.push_back({mid,iv._b,fm,iv._fb,iv._depth+1});
+	  continue;
+	}
+	leaves.push_back(iv);
+      }
+      std::sort(leaves.begin(),leaves.end(),
+		[](const Interval& l,const Interval& r){return l._a<r._a;});
+
+      auto slope=[&leaves](size_t i){
+	const auto& iv=leaves[i];
+	return std::abs(iv._fb-iv._fa)/std::abs(iv._b-iv._a);
+      };
+      double bound=0;
+      for(size_t i=0;i<leaves.size();++i){
+	double L=slope(i);
+	if(i>0) L=std::max(L,slope(i-1));
+	if(i+1<leaves.size()) L=std::max(L,slope(i+1));
+	const auto& iv=leaves[i];
+	auto top=(iv._fa+iv._fb)/2+L*std::abs(iv._b-iv._a)/2;
+	bound=std::max(bound,top);
+      }
+      return bound;
+    }
+
+    //i-th point of a Kronecker sequence in the box, for checks
+    //which should not line up with grid nodes, up to 3 dimensions
+    void kroneckerPoint(int i,const std::vector<double>& lower,const std::vector<double>& upper,double* x){
+      const double irrational[3]={std::sqrt(2.)-1,std::sqrt(3.)-1,std::sqrt(5.)-2};
+      for(size_t id=0;id<lower.size();++id){
+	auto frac=(i+1)*irrational[id];
+	x[id]=lower[id]+(frac-std::floor(frac))*(upper[id]-lower[id]);
+      }
+    }
+    //doubles needed for all elements of sdme
+    size_t sdmeSize(const SDME* sdme){
+      if(sdme==nullptr) return 0;
+      return 2*sdme->AlphaMax()*(sdme->Spin()+1)*(2*sdme->Spin()+1);
+    }
+    //real and imaginary parts in alpha, x, y order
+    void packSDME(const SDME* sdme,double* values){
+      if(sdme==nullptr) return;
+      const int J=sdme->Spin();
+      for(uint alpha=0;alpha<sdme->AlphaMax();++alpha)
+	for(int x=0;x<=J;++x)
+	  for(int y=-J;y<=J;++y){
+	    auto val=sdme->Val(alpha,x,y);
+	    *values++=std::real(val);
+	    *values++=std::imag(val);
+	  }
+    }
+    void unpackSDME(SDME* sdme,const double* values){
+      if(sdme==nullptr) return;
+      const int J=sdme->Spin();
+      for(uint alpha=0;alpha<sdme->AlphaMax();++alpha)
+	for(int x=0;x<=J;++x)
+	  for(int y=-J;y<=J;++y){
+	    sdme->SetElement(alpha,x,y,{values[0],values[1]});
+	    values+=2;
+	  }
+    }
+  }
+  /////////////////////////////////////////////////////////////////
+  DecayModelst::STKinematics& DecayModelst::Kin() const noexcept{
+    if(scanState._model==this) return *scanState._kin;
+    return _kin;
+  }
   ///////////////////////////////////////////////////////
   ///constructor includes subseqent decay of Ngamma* system
   DecayModelst::DecayModelst(particle_ptrs parts, const std::vector<int> pdgs) :
@@ -54,30 +182,36 @@ namespace elSpectro{
     _target = _prodInfo->_target;
     _ebeam = _prodInfo->_ebeam;
     _photonPol = _prodInfo->_photonPol;
+
+    BuildGrid();
+    BuildSqueeze();
     
      double maxW = ( *(_prodInfo->_target) + *(_prodInfo->_ebeam) ).M();
 
-     _max = FindMaxOfIntensity()*1.08; //add 5% for Q2,meson mass effects etc.
+     auto& cache=Manager::Instance().Cache();
+     InitCache::context_t context{Parent()->MinimumMassPossible(),_prodInfo->_Wmax,_target->M(),
+	 _meson->PdgMass(),_meson->MinimumMassPossible(),_baryon->Mass(),
+	 static_cast<double>(_meson->Pdg()),static_cast<double>(_baryon->Pdg())};
+     if(cache.Get("DecayModelst::_max/"+GetName(),context,_max))
+       _Wmax = _prodInfo->_Wmax;
+     else{
+       _max = FindMaxOfIntensity()*1.08; //add 5% for Q2,meson mass effects etc.
+       cache.Put("DecayModelst::_max/"+GetName(),context,_max);
+     }
 
      std::cout<<"DecayModelst::PostInit max value "<<_max<<" "<<_meson<<" "<<_meson->Pdg()<<" "<<_sdmeMeson<<std::endl;
   }
   
-  //////////////////////////////////////////////////////////////////
-  double DecayModelst::Intensity() const
-  {
-    /*A      B        A/2    B/2        A*2/3   B   
-      1      2         1/2    1          1/3    1   30each    5     10       
-      1/2    1   -->   1/4    1/2  --->  1/6    1/2  ---->    5/2   5
-      0      2         0      1                 1   row       0     10
-
-     */
-    _W = Parent()->P4().M();
-    _s=_W*_W;
-    _t = (_meson->P4()-*_photon).M2();//_amp->kinematics->t_man(s,cmMeson.Theta());
+  ///s, t, photon polarisation angle and t range of the product
+  ///vectors, false if below threshold for the meson and baryon masses
+  bool DecayModelst::SetEventKinematics() const{
+    auto& kin=Kin();
+    kin._W = Parent()->P4().M();
+    kin._s=kin._W*kin._W;
+    kin._t = (_meson->P4()-*_photon).M2();//_amp->kinematics->t_man(s,cmMeson.Theta());
     _dt=0;
-    _dsigma=0;
     //check above threshold for meson and baryon masses
-    if( _W < (_meson->P4().M()+_baryon->P4().M()) ) return 0;
+    if( kin._W < (_meson->P4().M()+_baryon->P4().M()) ) return false;
     //std::cout<<"DecayModelst "<<Parent()->Pdg()<<" "<<_meson->P4().M()<<" "<<_baryon->P4().M()<<std::endl;
 
     if(_isElProd==kTRUE){
@@ -91,36 +225,114 @@ namespace elSpectro{
     }
 
     //now kinemaics
-    _dt=4* TMath::Sqrt(PgammaCMsq())  * kine::PDK(_W,_meson->P4().M(),_baryon->P4().M() );
+    _dt=4* TMath::Sqrt(PgammaCMsq())  * kine::PDK(kin._W,_meson->P4().M(),_baryon->P4().M() );
+    return true;
+  }
+  //////////////////////////////////////////////////////////////////
+  double DecayModelst::Intensity() const
+  {
+    /*A      B        A/2    B/2        A*2/3   B   
+      1      2         1/2    1          1/3    1   30each    5     10       
+      1/2    1   -->   1/4    1/2  --->  1/6    1/2  ---->    5/2   5
+      0      2         0      1                 1   row       0     10
+
+     */
+    if(SetEventKinematics()==false) return 0;
+    auto& kin=Kin();
       
     double weight = DifferentialXSect() * _dt ;//must multiply by t-range for correct sampling
   
-    CalcMesonSDMEs();
-    CalcBaryonSDMEs();
-
     weight/=_max; //normalise range 0-1
     if(_isElProd==kTRUE)
-      weight/= TMath::Sqrt(PgammaCMsq()/kine::PDK2(_W,0,_target->M())); //correct max for finite Q2 phase space
+      weight/= TMath::Sqrt(PgammaCMsq()/kine::PDK2(kin._W,0,_target->M())); //correct max for finite Q2 phase space
  
-    if(weight>1){
+    //adaptive envelopes or weighted events correct for this when accepting
+    //unless retries keep the parent, see DecayingParticle::GenerateProducts
+    const bool reportHigh = RegenerateOnFail()==false
+      || (Manager::Instance().AdaptiveEnvelopes()==false && Manager::Instance().WeightedEvents()==false);
+    if(weight>1 && reportHigh){
       //don't change weight, likely due to large Q2 value....
-      std::cout<<"DecayModelst::Intensity weight too high but won't change maxprobable low meson mass and W from  "<<_max<<" to "<<weight*_max<<" meson "<<_meson->Mass()<<" W "<<_W<<std::endl;
+      std::cout<<"DecayModelst::Intensity weight too high but won't change maxprobable low meson mass and W from  "<<_max<<" to "<<weight*_max<<" meson "<<_meson->Mass()<<" W "<<kin._W<<std::endl;
       }
     
     //Correct for W weighting which has already been applied
     weight/=_prodInfo->_sWeight;
     // std::cout<<" s weight "<<_prodInfo->_sWeight<<" weight "<<weight<<" "<<_W<<std::endl;
-    if(weight>1){
-      std::cout<<" s weight "<<_prodInfo->_sWeight<<" Q2 "<<-_photon->M2()<<" 2Mmu "<<2*_target->M()*_photon->E() <<" W "<<_W<<" t "<<_t<<" new weight "<<weight*_prodInfo->_sWeight<<" meson "<<_meson->Mass()<<std::endl;
+    if(weight>1 && reportHigh){
+      std::cout<<" s weight "<<_prodInfo->_sWeight<<" Q2 "<<-_photon->M2()<<" 2Mmu "<<2*_target->M()*_photon->E() <<" W "<<kin._W<<" t "<<kin._t<<" new weight "<<weight*_prodInfo->_sWeight<<" meson "<<_meson->Mass()<<std::endl;
       std::cout<<"DecayModelst::Intensity sWeight corrected weight too large "<<weight <<" "<<_prodInfo->_sWeight<<"  max "<<_max<<" val "<< weight*_prodInfo->_sWeight*_max<<std::endl;
-      std::cout<<"DX "<<DifferentialXSect()<<" "<< _dt<<" pgam "<<TMath::Sqrt(PgammaCMsq())<<" M^2 "<<MatrixElementsSquared_T()<<" Q2 factor "<<TMath::Sqrt(PgammaCMsq())/kine::PDK(_W,0,_baryon->Mass())<<" PHASE SPACE "<<PhaseSpaceFactor()<<" s "<<_s<<" pgam "<<PgammaCMsq()<<" at Q2 0  = "<<kine::PDK2(_W,0,_target->M())<<std::endl;
+      std::cout<<"DX "<<DifferentialXSect()<<" "<< _dt<<" pgam "<<TMath::Sqrt(PgammaCMsq())<<" M^2 "<<MatrixElementsSquared_T()<<" Q2 factor "<<TMath::Sqrt(PgammaCMsq())/kine::PDK(kin._W,0,_baryon->Mass())<<" PHASE SPACE "<<PhaseSpaceFactor()<<" s "<<kin._s<<" pgam "<<PgammaCMsq()<<" at Q2 0  = "<<kine::PDK2(kin._W,0,_target->M())<<std::endl;
       }
      
  
     return weight;
     
   }
-  
+  ///Intensity() with the matrix elements replaced by their bounds,
+  ///the other factors are exact. Where Intensity() interpolates the
+  ///grid the interpolation itself is bounded, which is guaranteed,
+  ///else the squeeze table which passed its check at PostInit
+  bool DecayModelst::IntensityBounds(double& lower,double& upper) const{
+    if(_squeezePoints.empty()) return false;
+    if(_grid.get()==nullptr && _squeeze.get()==nullptr) return false;
+    if(SetEventKinematics()==false){
+      lower=upper=0;
+      return true;
+    }
+    double x[3];
+    double meT[2];
+    double meL[2];
+    if(GridPoint(_grid.get(),x)){
+      //as GridMatrixElements
+      _grid->InterpolatedBounds(x,0,meT[0],meT[1]);
+      _grid->InterpolatedBounds(x,1,meL[0],meL[1]);
+      for(auto* me:{meT,meL}){
+	me[0]=std::max(me[0],0.);
+	me[1]=std::max(me[1],0.);
+      }
+    }
+    else if(GridPoint(_squeeze.get(),x)){
+      _squeeze->CellBounds(x,0,meT[0],meT[1]);
+      _squeeze->CellBounds(x,1,meL[0],meL[1]);
+    }
+    else return false;
+    auto epsDelta=_photonPol->Epsilon()+_photonPol->Delta();
+    auto L0=epsDelta*meL[0];
+    auto L1=epsDelta*meL[1];
+
+    auto factor=PhaseSpaceFactor()*_dt/_max/_prodInfo->_sWeight;
+    if(_isElProd==kTRUE)
+      factor/= TMath::Sqrt(PgammaCMsq()/kine::PDK2(Kin()._W,0,_target->M()));
+    lower=std::max(factor*(meT[0]+std::min(L0,L1)),0.);
+    upper=std::max(factor*(meT[1]+std::max(L0,L1)),0.);
+    return true;
+  }
+  ///SDMEs are only needed by the products decays, so they wait
+  ///until Intensity() is accepted, Kin() is still for this event
+  void DecayModelst::PostAccept() const{
+    if(GridSDMEs()==false){
+      CalcMesonSDMEs();
+      CalcBaryonSDMEs();
+    }
+  }
+  /////////////////////////////////////////////////////////////////
+  ///photon and meson in the W rest frame give t
+  double DecayModelst::dsigma_costhWQ2(double cosTh,double W,double Q2,double epsDelta) const{
+    STKinematics kin;
+    ScanKinematics useKin(this,kin);
+    kin._W=W;
+    kin._s=W*W;
+    kin._Q2=Q2;
+    if( W < (_meson->P4().M()+_baryon->P4().M()) ) return 0.;
+
+    auto pgamma2=PgammaCMsq();
+    auto Egamma=TMath::Sqrt(pgamma2-Q2);
+    kin._t = -Q2 + _meson->M2() - 2 * (Egamma* kinCM_MesonE(W)-TMath::Sqrt(pgamma2)* kinCM_MesonP(W)*cosTh);
+    return PhaseSpaceFactorCosTh()*(MatrixElementsSquared_T()+epsDelta*MatrixElementsSquared_L()) ;//2pi=>integrated over phi
+  }
+  /////////////////////////////////////////////////////////////////
+  ///Maximum of dsigma/dt*(t range) over W and cos(theta) from a
+  ///grid search seeding local fits, also done for the minimum meson mass
   double DecayModelst::FindMaxOfIntensity(){
     
     auto M1 = 0;//assum real photon for max calculation
@@ -134,114 +346,236 @@ namespace elSpectro{
     
     std::cout<<" DecayModelst::FindMaxOfIntensity()  Wmin = "<<Wmin<<" Wmax = "<<_Wmax<<" meson mass = "<<M3<<" baryon mass = "<<M4<<" target mass = "<<M2<<std::endl;
 
+    //may be called from many threads so has its own kinematics
     auto Fmax = [&M1,&M2,&M3,&M4,&Wmin,this](const double *x)
       {
-	_s = x[0]*x[0];
-	_W=x[0];
-	if( _W < Wmin ) return 0.;
-	if( _W < M3+M4 ) return 0.;
-	if( _W > _Wmax ) return 0.;
-
-	auto currt=kine::tFromcosthW(x[1],_W,M1,M2,M3,M4);
-	auto myt0=kine::t0(_W,M1,M2,M3,M4);
-	auto mytmax=kine::tmax(_W,M1,M2,M3,M4);
+	STKinematics kin;
+	ScanKinematics useKin(this,kin);
+	kin._s = x[0]*x[0];
+	kin._W=x[0];
+	if( kin._W < Wmin ) return 0.;
+	if( kin._W < M3+M4 ) return 0.;
+	if( kin._W > _Wmax ) return 0.;
+
+	auto currt=kine::tFromcosthW(x[1],kin._W,M1,M2,M3,M4);
+	auto myt0=kine::t0(kin._W,M1,M2,M3,M4);
+	auto mytmax=kine::tmax(kin._W,M1,M2,M3,M4);
 	if(currt>myt0) return 0.;
 	if(currt<mytmax) return 0.;
 	if( TMath::IsNaN(x[1]) ) return 0.;
 
-	_t=currt;
-	auto dt=4* TMath::Sqrt(PgammaCMsq())  * kine::PDK(_W,M3,M4 );
+	kin._t=currt;
+	auto dt=4* TMath::Sqrt(PgammaCMsq())  * kine::PDK(kin._W,M3,M4 );
 
 	double val = DifferentialXSect()*dt;
 	if( TMath::IsNaN(val) ) return 0.;
-	return -(val); //using a minimiser!
+	return val;
       };
-   
-      //First perform grid search for intital values
-      double Wrange=_Wmax-Wmin;
-      double tmax=kine::tmax(_Wmax,M1,M2,M3,M4);
-       
-      double gridMin=0;
-      double gridW=0;
-      double gridt=0;
-      double WtVals[2];
-   
-      ROOT::Math::Minimizer* minimum =
-	ROOT::Math::Factory::CreateMinimizer("Genetic", "");
-      //	ROOT::Math::Factory::CreateMinimizer("Minuit2", "Combined");
 
-      if(minimum==nullptr) //Minuit2 not always installed!
-	minimum = ROOT::Math::Factory::CreateMinimizer("Minuit", "");
-      
-      // set tolerance , etc...
-      minimum->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2
-      minimum->SetMaxIterations(1000);  // for GSL
-      minimum->SetTolerance(0.0001);
-      minimum->SetPrintLevel(0);
-      
-      // create function wrapper for minimizer
-      // a IMultiGenFunction type
-      ROOT::Math::Functor wrapf(Fmax,2);
-
-      //variable = W, variable 1 = t
-      // double step[2] = {Wrange/500,0.001};
-      double step[2] = {Wrange/100,2./100};
-      // starting point
-      
-      // double variable[2] = { gridW,gridt};
-      double variable[2] = {Wmin+Wrange/2,0};
-      
-      minimum->SetFunction(wrapf);
-      
-      // Set the free variables to be minimized !
-      minimum->SetVariable(0,"W",variable[0], step[0]);
-      minimum->SetVariable(1,"t",variable[1], step[1]);
-      // minimum->SetVariableLimits(0,Wmin,_Wmax);
-      // minimum->SetVariableLimits(1,tmax,0);
-
-      // do the minimization
-      minimum->Minimize();
-      const double *xs = minimum->X();
- 
-      auto minVal = minimum->MinValue();
-      auto minW= xs[0];
-      auto mint= kine::tFromcosthW(xs[1],minW,M1,M2,M3,M4);//xs[1];
-   
-      std::cout << "Maximum : Probabiltiy Dist at ( W=" << minW << " , t = "  << mint << "): "<< -minimum->MinValue()  << " note t0 "<<kine::t0(minW,M1,M2,M3,M4)<< std::endl;
+    //variable 0 = W, variable 1 = cos(theta)
+    auto findMax=[&](){
+      auto result = maximise::multiStart(Fmax,{Wmin,-1},{_Wmax,1},50,8,CanEvaluateConcurrently());
+      auto maxW=result._x[0];
+      std::cout << "Maximum : Probabiltiy Dist at ( W=" << maxW << " , t = "  << kine::tFromcosthW(result._x[1],maxW,M1,M2,M3,M4) << "): "<< result._max << " bound "<<result._bound<<" (fits gained up to "<<result._margin*100<<"% on grid) note t0 "<<kine::t0(maxW,M1,M2,M3,M4)<< std::endl;
+      return result._bound;
+    };
 
-      //check for low mass meson limits
-      if(dynamic_cast<DecayingParticle*>(_meson)){ //meson
-	dynamic_cast<DecayingParticle*>(_meson)->TakeMinimumMass();//to get threshold behaviour
-	M3=_meson->Mass();
-	
-	// do the minimization at min mass in case higher max
-	minimum->Minimize();
-	const double *xs = minimum->X();
-	
-	auto minminVal = minimum->MinValue();
-	
+    auto maxVal=findMax();
 
-	if(minminVal<minVal){
-	  std::cout << "Minimum Mass Maximum : Probabiltiy Dist at ( W=" << minW << " , t = "  << mint << "): "<< -minimum->MinValue()<< " note t0 "<<kine::t0(minW,M1,M2,M3,M4)  << std::endl;
-	  std::cout<<"minmin "<<-minminVal<<" < "<<-minVal<<std::endl;
-	  minVal=minminVal;
-	  minW= xs[0];
-	  mint= xs[1];
-	}
-	//back to PDg mass if exists
-	if(_meson->PdgMass()>M3)
-	  M3=_meson->PdgMass();
-	  dynamic_cast<DecayingParticle*>(_meson)->TakePdgMass();
+    //check for low mass meson limits
+    if(dynamic_cast<DecayingParticle*>(_meson)){ //meson
+      dynamic_cast<DecayingParticle*>(_meson)->TakeMinimumMass();//to get threshold behaviour
+      M3=_meson->Mass();
 
+      // do the maximisation at min mass in case higher max
+      auto minMassVal=findMax();
+      if(minMassVal>maxVal){
+	std::cout<<"DecayModelst::FindMaxOfIntensity() minimum meson mass max "<<minMassVal<<" > "<<maxVal<<std::endl;
+	maxVal=minMassVal;
       }
+      //back to PDg mass
+      dynamic_cast<DecayingParticle*>(_meson)->TakePdgMass();
+    }
+
+    return maxVal;
+  }
+  ///Tabulate the matrix elements and SDMEs. Nodes are shared between
+  ///threads if the model allows it and neither the meson mass nor the
+  ///SDMEs have to be set, then the interpolation is compared with
+  ///direct evaluation at quasi-random points
+  void DecayModelst::BuildGrid(){
+    if(_gridPoints.empty()) return;
+
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<int> npoints;
+    _gridMass=GridDomain(_gridPoints,lower,upper,npoints);
+    const bool mass=_gridMass;
+    const int nvalues=2+sdmeSize(_sdmeMeson)+sdmeSize(_sdmeBaryon);
+    _gridSDMEs.resize(nvalues-2);
+    const bool sdmes=nvalues>2;
+    const bool concurrent=CanEvaluateConcurrently() && mass==false && sdmes==false;
+
+    std::unique_ptr<InterpolationGrid> grid{new InterpolationGrid{lower,upper,npoints,nvalues}};
+    std::cout<<"DecayModelst::BuildGrid "<<grid->NNodes()<<" nodes in W, cos(theta)"<<(mass ? ", meson mass" : "")<<" with "<<nvalues<<" values each"<<std::endl;
+    grid->Fill([this,mass,sdmes](const double* x,double* values){GridValues(x,mass,sdmes,values);},concurrent);
 
-      if(gridMin<minVal){
-	Warning("DecayModelst::FindMaxOfIntensity()","grid search value already bigger than minimised, so will revert to that max value +5 percent");
-	std::cout<<"gridMin "<<gridMin<<" "<<minVal<<std::endl;
-	minVal=gridMin*1.05;
+    const int ncheck=500;
+    std::vector<double> direct(ncheck*nvalues);
+    std::vector<double> interpolated(ncheck*nvalues);
+    threads::parallelFor(ncheck,[&](int icheck){
+	double x[3];
+	kroneckerPoint(icheck,lower,upper,x);
+	GridValues(x,mass,sdmes,&direct[icheck*nvalues]);
+	grid->Interpolate(x,&interpolated[icheck*nvalues]);
+      },concurrent);
+    if(mass) dynamic_cast<DecayingParticle*>(_meson)->TakePdgMass();
+
+    //largest difference relative to the largest value, for each value
+    double worst=0;
+    int worstValue=0;
+    for(int iv=0;iv<nvalues;++iv){
+      double scale=0;
+      double diff=0;
+      for(int ic=0;ic<ncheck;++ic){
+	scale=std::max(scale,std::abs(direct[ic*nvalues+iv]));
+	diff=std::max(diff,std::abs(direct[ic*nvalues+iv]-interpolated[ic*nvalues+iv]));
+      }
+      if(scale>0 && diff/scale>worst){
+	worst=diff/scale;
+	worstValue=iv;
       }
+    }
+    std::cout<<"DecayModelst::BuildGrid largest interpolation error "<<worst*100<<"% of maximum, value "<<worstValue<<" (0,1 = T,L matrix elements, then SDMEs)"<<std::endl;
+    if(worst>0.01)
+      std::cout<<"Warning DecayModelst::BuildGrid interpolation error above 1%, consider more points in UseGrid"<<std::endl;
+
+    _grid=std::move(grid);
+  }
+  ///With UseGrid the interpolation is bounded exactly, no table
+  ///is needed. Else matrix elements at the nodes of their own grid,
+  ///bounds for IntensityBounds() come from the nodes around each cell.
+  ///These are estimates, so direct evaluation at quasi-random points
+  ///is checked and any point outside turns the squeeze off
+  void DecayModelst::BuildSqueeze(){
+    if(_squeezePoints.empty()) return;
+    if(_grid.get()!=nullptr){
+      std::cout<<"DecayModelst::BuildSqueeze bounds from the interpolation grid"<<std::endl;
+      return;
+    }
+
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<int> npoints;
+    _squeezeMass=GridDomain(_squeezePoints,lower,upper,npoints);
+    const bool mass=_squeezeMass;
+    const bool concurrent=CanEvaluateConcurrently() && mass==false;
+
+    std::unique_ptr<InterpolationGrid> squeeze{new InterpolationGrid{lower,upper,npoints,2}};
+    std::cout<<"DecayModelst::BuildSqueeze "<<squeeze->NNodes()<<" nodes in W, cos(theta)"<<(mass ? ", meson mass" : "")<<std::endl;
+    squeeze->Fill([this,mass](const double* x,double* values){GridValues(x,mass,false,values);},concurrent);
+
+    const int ncheck=std::max<int>(2000,squeeze->NNodes()/4);
+    std::vector<int> outside(ncheck,0);
+    threads::parallelFor(ncheck,[&](int icheck){
+	double x[3];
+	kroneckerPoint(icheck,lower,upper,x);
+	double direct[2];
+	GridValues(x,mass,false,direct);
+	for(int iv=0;iv<2;++iv){
+	  double low=0;
+	  double high=0;
+	  squeeze->CellBounds(x,iv,low,high);
+	  if(direct[iv]<low || direct[iv]>high) outside[icheck]=1;
+	}
+      },concurrent);
+    if(mass) dynamic_cast<DecayingParticle*>(_meson)->TakePdgMass();
+
+    auto nout=std::count(outside.begin(),outside.end(),1);
+    if(nout>0){
+      std::cout<<"Warning DecayModelst::BuildSqueeze matrix elements outside their bounds at "<<nout<<" of "<<ncheck<<" test points, squeeze is off. Use more points in UseSqueeze or UseGrid"<<std::endl;
+      return;
+    }
+    std::cout<<"DecayModelst::BuildSqueeze matrix elements inside their bounds at all "<<ncheck<<" test points"<<std::endl;
+    _squeeze=std::move(squeeze);
+  }
+  ///W and cos(theta) ranges, with the meson mass if it has a
+  ///mass distribution and points[2]>1, returns true with mass
+  bool DecayModelst::GridDomain(const std::vector<int>& points,std::vector<double>& lower,
+				std::vector<double>& upper,std::vector<int>& npoints) const{
+    auto Wmax = _prodInfo->_Wmax;
+    lower={Parent()->MinimumMassPossible(),-1};
+    upper={Wmax,1};
+    npoints={points[0],points[1]};
+
+    auto meson=dynamic_cast<DecayingParticle*>(_meson);
+    if(meson==nullptr || points[2]<2) return false;
+    auto mMin=meson->MinimumMassPossible();
+    auto mMax=std::min(meson->MaximumMassPossible(),Wmax-_baryon->Mass());
+    if(mMax<=mMin) return false;
+    lower.push_back(mMin);
+    upper.push_back(mMax);
+    npoints.push_back(points[2]);
+    return true;
+  }
+  ///Direct evaluation for a real photon, values are
+  ///T and L matrix elements then meson and baryon SDMEs
+  void DecayModelst::GridValues(const double* x,bool mass,bool sdmes,double* values) const{
+    STKinematics kin;
+    ScanKinematics useKin(this,kin);
+    if(mass) dynamic_cast<DecayingParticle*>(_meson)->TakeMass(x[2]);
+
+    std::fill(values,values+2+(sdmes ? _gridSDMEs.size() : 0),0.);
+    auto M3 = _meson->Mass();
+    auto M4 = _baryon->Mass();
+    if( x[0] < M3+M4 ) return;
+
+    kin._W=x[0];
+    kin._s=x[0]*x[0];
+    kin._Q2=0;
+    kin._t=kine::tFromcosthW(x[1],kin._W,0,_target->M(),M3,M4);
+
+    auto meT=MatrixElementsSquared_T();
+    auto meL=MatrixElementsSquared_L();
+    values[0] = std::isnan(meT) ? 0 : meT;
+    values[1] = std::isnan(meL) ? 0 : meL;
+    if(sdmes==false) return;
 
-      return -minVal;
+    CalcMesonSDMEs();
+    CalcBaryonSDMEs();
+    packSDME(_sdmeMeson,values+2);
+    packSDME(_sdmeBaryon,values+2+sdmeSize(_sdmeMeson));
+  }
+  ///Grid coordinates of the current kinematics, t is taken as
+  ///real photon t so finite Q2 points may fall outside
+  bool DecayModelst::GridPoint(const InterpolationGrid* grid,double* x) const{
+    if(grid==nullptr) return false;
+    const auto& kin=Kin();
+    x[0]=kin._W;
+    x[1]=kine::costhFromt(kin._t,kin._W,0,_target->M(),_meson->Mass(),_baryon->Mass());
+    x[2]=_meson->Mass();
+    if(std::isnan(x[1])) return false;
+    return grid->Inside(x);
+  }
+  /////////////////////////////////////////////////////////////////
+  bool DecayModelst::GridMatrixElements(double& meT,double& meL) const{
+    double x[3];
+    if(GridPoint(_grid.get(),x)==false) return false;
+    double me[2];
+    _grid->Interpolate(x,me,0,2);
+    meT=std::max(me[0],0.);
+    meL=std::max(me[1],0.);
+    return true;
+  }
+  /////////////////////////////////////////////////////////////////
+  bool DecayModelst::GridSDMEs() const{
+    if(_gridSDMEs.empty()) return false;
+    double x[3];
+    if(GridPoint(_grid.get(),x)==false) return false;
+    _grid->Interpolate(x,_gridSDMEs.data(),2);
+    unpackSDME(_sdmeMeson,_gridSDMEs.data());
+    unpackSDME(_sdmeBaryon,_gridSDMEs.data()+sdmeSize(_sdmeMeson));
+    return true;
   }
   /*
   void DecayModelst::HistIntegratedXSection(TH1D& hist){
@@ -298,12 +632,13 @@ namespace elSpectro{
     auto M3 = _meson->Mass(); //should be pdg value here
     auto M4 = _baryon->Mass();
     auto Wmin = M3+M4;
+    auto& kin=Kin();
  
     //integrate over costh
-    auto F = [this,M1,M2,M3,M4](double costh)
+    auto F = [this,&kin,M1,M2,M3,M4](double costh)
       {
-	_s=_W*_W;
-	_t = kine::tFromcosthW(costh, _W, M1, M2, M3, M4);
+	kin._s=kin._W*kin._W;
+	kin._t = kine::tFromcosthW(costh, kin._W, M1, M2, M3, M4);
 	return PhaseSpaceFactorCosTh()* (MatrixElementsSquared_T());
      };
     
@@ -315,8 +650,8 @@ namespace elSpectro{
       
   
       for(int ih=1;ih<=hist.GetNbinsX();ih++){
-	_W=hist.GetXaxis()->GetBinCenter(ih);
-	if( _W < Wmin )
+	kin._W=hist.GetXaxis()->GetBinCenter(ih);
+	if( kin._W < Wmin )
 	  hist.SetBinContent(ih, 0);
 	else
 	  hist.SetBinContent(ih, ig.Integral(-1,1) );
@@ -334,14 +669,15 @@ namespace elSpectro{
     auto M3 = _meson->Mass(); //should be pdg value here
     auto M4 = _baryon->Mass();
     auto Wmin = M3+M4;
+    auto& kin=Kin();
 
-    auto F = [this,M1,M2,M3,M4](double t)
+    auto F = [this,&kin,M1,M2,M3,M4](double t)
       {
 	//_W=W;
-	_s=_W*_W;
+	kin._s=kin._W*kin._W;
 	//_t=t;
 	//_W = Parent()->P4().M();
-	_t = kine::tFromcosthW(t, _W, M1, M2, M3, M4);
+	kin._t = kine::tFromcosthW(t, kin._W, M1, M2, M3, M4);
 	return PhaseSpaceFactorCosTh()* (MatrixElementsSquared_T());
      };
     
@@ -353,9 +689,9 @@ namespace elSpectro{
       
   
       for(int ih=1;ih<=hist.GetNbinsX();ih++){
-	_W=sqrt(hist.GetXaxis()->GetBinCenter(ih));
+	kin._W=sqrt(hist.GetXaxis()->GetBinCenter(ih));
 	//	_W=_W+hist.GetXaxis()->GetBinWidth(ih); //take right limit so do not miss threshold
-	if( _W < Wmin )
+	if( kin._W < Wmin )
 	  hist.SetBinContent(ih, 0);
 	else
 	  hist.SetBinContent(ih, ig.Integral(-1,1) );
@@ -366,6 +702,9 @@ namespace elSpectro{
       //done
   }
   
+  ///Maximum of dsigma/dt*(t range) in each W bin, checking
+  ///bin centre and edges. Bins are shared between threads, each with
+  ///its own kinematics, and t is refined where the cross section varies
   void DecayModelst::HistMaxXSection(TH1D& hist){
 
  
@@ -375,64 +714,101 @@ namespace elSpectro{
     auto M4 = _baryon->Mass();
     //auto Wmin = M3+M4;
     auto Wmin = Parent()->MinimumMassPossible();
- 
-    auto F = [this,&Wmin](double t)
-      {
-	//_W=W;
-	if(_W<Wmin)return 0.;
-	_s=_W*_W;
-	_t=t;
-	return DifferentialXSect();
-      };
-    
-   
-      
- 
-      for(int ih=1;ih<=hist.GetNbinsX();ih++){
-	_W=hist.GetXaxis()->GetBinCenter(ih);
-	if( _W < Wmin )
-	  hist.SetBinContent(ih, 0);
-	else if( TMath::IsNaN(kine::tmax(_W,M1,M2,M3,M4)) )
-	  hist.SetBinContent(ih, 0);
-	else if( TMath::IsNaN(kine::t0(_W,M1,M2,M3,M4)) )
-	  hist.SetBinContent(ih, 0);
-	else{
-	  double max_at_W=0;
-	  double tmax=kine::tmax(_W,M1,M2,M3,M4);
-	  double tmin=kine::t0(_W,M1,M2,M3,M4);
-	  int Ntpoints=100;
-	  double tstep=(tmax-tmin)/Ntpoints;
-	  double tval=tmin;
-	  for(int itt=0;itt<Ntpoints;itt++){
-	    _W=hist.GetXaxis()->GetBinCenter(ih);
-	    
-	    double val_at_t = F(tval)*(tmin-tmax);
-	    if(val_at_t>max_at_W)
-	      max_at_W=val_at_t;
-
-	    
-	    _W=_W+hist.GetXaxis()->GetBinWidth(ih)/2; //take right limit
-	    val_at_t = F(tval)*(tmin-tmax);
-	    if(val_at_t>max_at_W)
-	      max_at_W=val_at_t;
-	    
-	    _W=_W-hist.GetXaxis()->GetBinWidth(ih); //take left limit 
-	    val_at_t = F(tval)*(tmin-tmax);
-	    if(val_at_t>max_at_W)
-	      max_at_W=val_at_t;
-	    
-	    //move on
-	    tval+=tstep;
-	  }
-	  hist.SetBinContent(ih, max_at_W );
 
-	}
+    const auto* axis=hist.GetXaxis();
+    const int Nbins=hist.GetNbinsX();
+    std::vector<double> maxInBin(Nbins+1,0);
+
+    auto maxForBin=[&](int ibin){
+      int ih=ibin+1;
+      STKinematics kin;
+      ScanKinematics useKin(this,kin);
+
+      double Wcentre=axis->GetBinCenter(ih);
+      if( Wcentre < Wmin ) return;
+      double tmax=kine::tmax(Wcentre,M1,M2,M3,M4);
+      double tmin=kine::t0(Wcentre,M1,M2,M3,M4);
+      if( TMath::IsNaN(tmax) || TMath::IsNaN(tmin) ) return;
+
+      auto F = [this,&kin,&Wmin,tmin,tmax](double t)
+	{
+	  if(kin._W<Wmin)return 0.;
+	  kin._s=kin._W*kin._W;
+	  kin._t=t;
+	  return DifferentialXSect()*(tmin-tmax);
+	};
+
+      double max_at_W=0;
+      auto halfWidth=axis->GetBinWidth(ih)/2;
+      //centre, right and left limit
+      for(auto W:{Wcentre,Wcentre+halfWidth,Wcentre-halfWidth}){
+	kin._W=W;
+	max_at_W=std::max(max_at_W,adaptiveMax(F,tmax,tmin));
       }
-      //	if(ih%10==0)std::cout<<(hist.GetNbinsX() - ih)/10<<" "<<std::endl;
-  
+      maxInBin[ih]=max_at_W;
+    };
+    threads::parallelFor(Nbins,maxForBin,CanEvaluateConcurrently());
+
+    for(int ih=1;ih<=Nbins;ih++)
+      hist.SetBinContent(ih, maxInBin[ih] );
+
       std::cout<<std::endl;
       //done
   }
+  ///Maximum over t of dsigma/dt*(t range) with the finite Q2
+  ///correction of Intensity, in bins of W (x) and Q2 (y).
+  ///Checks the W centre and edges at both Q2 edges of each bin
+  void DecayModelst::HistMaxXSection(TH2D& hist){
+
+    auto M2 = _target->M();
+    auto M3 = _meson->Mass(); //should be pdg value here
+    auto M4 = _baryon->Mass();
+    auto Wmin = Parent()->MinimumMassPossible();
+
+    const auto* xaxis=hist.GetXaxis();
+    const auto* yaxis=hist.GetYaxis();
+    const int NbinsX=hist.GetNbinsX();
+    const int NbinsY=hist.GetNbinsY();
+    std::vector<double> maxInBin(NbinsX*NbinsY,0);
+
+    auto maxForBin=[&](int ibin){
+      int ix=ibin%NbinsX+1;
+      int iy=ibin/NbinsX+1;
+      STKinematics kin;
+      ScanKinematics useKin(this,kin);
+
+      double Wcentre=xaxis->GetBinCenter(ix);
+      if( Wcentre < Wmin ) return;
+      auto halfWidth=xaxis->GetBinWidth(ix)/2;
+
+      double max_in_bin=0;
+      for(auto Q2:{yaxis->GetBinLowEdge(iy),yaxis->GetBinUpEdge(iy)}){
+	for(auto W:{Wcentre,Wcentre+halfWidth,Wcentre-halfWidth}){
+	  if( W < Wmin ) continue;
+	  double tmin=kine::t0VirtualPhoton(W,Q2,M2,M3,M4);
+	  double tmax=tmin - 4*TMath::Sqrt(kine::PDK2VirtualPhoton(W,Q2,M2))*kine::PDK(W,M3,M4);
+	  if( TMath::IsNaN(tmax) || TMath::IsNaN(tmin) ) continue;
+	  
+	  kin._W=W;
+	  kin._s=W*W;
+	  kin._Q2=Q2;
+	  //as Intensity() for electroproduction
+	  auto Q2factor = TMath::Sqrt(kine::PDK2(W,0,M2)/PgammaCMsq());
+	  auto F = [this,&kin,tmin,tmax,Q2factor](double t)
+	    {
+	      kin._t=t;
+	      return DifferentialXSect()*(tmin-tmax)*Q2factor;
+	    };
+	  max_in_bin=std::max(max_in_bin,adaptiveMax(F,tmax,tmin));
+	}
+      }
+      maxInBin[ibin]=max_in_bin;
+    };
+    threads::parallelFor(NbinsX*NbinsY,maxForBin,CanEvaluateConcurrently());
+
+    for(int ibin=0;ibin<NbinsX*NbinsY;ibin++)
+      hist.SetBinContent(ibin%NbinsX+1,ibin/NbinsX+1, maxInBin[ibin] );
+  }
 }
 /* perhaps this can go in script for fixed values of sdmes
     //Meson spin density marix elements, note this is photoproduced
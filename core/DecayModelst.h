@@ -9,13 +9,21 @@
 ///
 ///            Note derived classes should include a constructor to initialise
 ///            DecayModelst( particle_ptrs , const std::vector<int> pdgs );
+///
+///            UseGrid() tabulates the matrix elements and SDMEs in W,
+///            cos(theta) (and meson mass) at PostInit and interpolates
+///            them while generating, UseSqueeze() bounds them so most
+///            trials are decided without evaluating them
 #pragma once
 
 #include "DecayModel.h"
 #include "SDME.h"
+#include "InterpolationGrid.h"
 #include "FunctionsForElectronScattering.h"
 #include "DecayingParticle.h"
 #include <TH1D.h>
+#include <TH2D.h>
+#include <memory>
 
 namespace elSpectro{
 
@@ -23,6 +31,14 @@ namespace elSpectro{
   class DecayModelst : public DecayModel {
 
   public:
+
+    //kinematics the cross section is evaluated at
+    struct STKinematics{
+      double _s={0};
+      double _t={0};
+      double _W={0};
+      double _Q2={-1}; //set by scans of virtual photons, else from the photon
+    };
     
     DecayModelst()=delete;
     //constructor giving jpac amplitude pointer (which we will now own)
@@ -31,6 +47,8 @@ namespace elSpectro{
     
     //
     double Intensity() const override; //this should perhaps be final so derived classes cannot overwrite...
+    //SDMEs for the meson and baryon decays
+    void PostAccept() const override;
     
     void PostInit(ReactionInfo* info) override;
 
@@ -41,18 +59,39 @@ namespace elSpectro{
     const Particle* GetBaryon() const noexcept{return _baryon; }
 
     void SetUseSDME(bool use=true){_useSDME=use;}
+
+    //tabulate matrix elements and SDMEs for real photons on a
+    //W x cos(theta) x meson mass grid at PostInit and interpolate
+    //them, points outside the grid are evaluated directly
+    //nmass is only used if the meson has a mass distribution
+    void UseGrid(int nW=200,int ncosth=100,int nmass=20){
+      _gridPoints={nW,ncosth,nmass};
+    }
+    const InterpolationGrid* Grid()const noexcept{return _grid.get();}
+
+    //bounds on the matrix elements so most trials are accepted or
+    //rejected without evaluating them, see DecayingParticle::GenerateProducts
+    //With UseGrid the interpolation is bounded exactly, else from
+    //a W x cos(theta) x meson mass table which is dropped if direct
+    //evaluation falls outside its bounds at PostInit
+    void UseSqueeze(int nW=100,int ncosth=50,int nmass=10){
+      _squeezePoints={nW,ncosth,nmass};
+    }
+    bool IntensityBounds(double& lower,double& upper) const override;
     
 
     /* double PgammaCMsq()const noexcept{*/
     double PgammaCMsq() const noexcept{
-      if(_photon->M()==0) return kine::PDK2(_W,0,_target->M());
+      if(Kin()._Q2>=0) return kine::PDK2VirtualPhoton(Kin()._W,Kin()._Q2,_target->M());
+      if(_photon->M()==0) return kine::PDK2(Kin()._W,0,_target->M());
       auto  pgammaCM= PgammaCM();
       return  pgammaCM* pgammaCM; //for dt phase space factor
     }
     
     double PgammaCM()const noexcept{
+      if(Kin()._Q2>=0) return TMath::Sqrt(PgammaCMsq());
       //in case no photon 4-vector yet
-      if(_photon->M()==0) return kine::PDK(_W,0,_target->M());
+      if(_photon->M()==0) return kine::PDK(Kin()._W,0,_target->M());
       //else PDK does not qork for virtual photons
       auto cmBoost=Parent()->P4().BoostToCM();
       auto p1cm=boost(*_photon,cmBoost);
@@ -78,6 +117,10 @@ namespace elSpectro{
     void HistIntegratedXSection_ds(TH1D& hist);
     void HistIntegratedXSection(TH1D& hist);
     void HistMaxXSection(TH1D& hist);
+    //x=W, y=Q2, max of the Intensity before normalisation
+    void HistMaxXSection(TH2D& hist);
+    //Intensity is normalised to this
+    double MaxIntensity() const noexcept{return _max;}
     
     double PhaseSpaceFactor() const noexcept {
       /* auto fluxPhaseSpace = p1*_W;//eqn 47.28b https://pdg.lbl.gov/2019/reviews/rpp2019-rev-kinematics.pdf
@@ -89,12 +132,12 @@ namespace elSpectro{
       //return PhaseSpaceNorm()/_s/kine::PDK2(_W,_photon->M(),_target->M());
       //Please note kine::PDK2(_W,_photon->M(),_target->M()) does not give
       //correct momentum
-      return PhaseSpaceNorm()/_s/PgammaCMsq();
+      return PhaseSpaceNorm()/Kin()._s/PgammaCMsq();
       //this would not be the case if the differential was dcosth rather than t
     }
     
     double PhaseSpaceFactorCosTh() const noexcept {
-      return PhaseSpaceNormCosTh()* kine::PDK(_W,_meson->Mass(),_baryon->Mass())/_s/PgammaCM();
+      return PhaseSpaceNormCosTh()* kine::PDK(Kin()._W,_meson->Mass(),_baryon->Mass())/Kin()._s/PgammaCM();
     }
     
   protected:
@@ -115,11 +158,28 @@ namespace elSpectro{
 
     double FindMaxOfIntensity();
 
+    void BuildGrid();
+    void BuildSqueeze();
+    bool GridDomain(const std::vector<int>& points,std::vector<double>& lower,
+		    std::vector<double>& upper,std::vector<int>& npoints) const;
+    //x = W, cos(theta) for a real photon, meson mass if mass
+    void GridValues(const double* x,bool mass,bool sdmes,double* values) const;
+    bool GridPoint(const InterpolationGrid* grid,double* x) const;
+    bool GridMatrixElements(double& meT,double& meL) const;
+    bool GridSDMEs() const;
+
   public:
-    double get_s() const noexcept{ return _s; }
-    double get_t() const noexcept { return _t; }
-    double get_W() const noexcept { return _W; }
-    double get_Q2() const noexcept { return -_photon->M2(); }
+    //while a scan is running on this thread the model is evaluated
+    //with the scan's own kinematics, so threads can share the model
+    STKinematics& Kin() const noexcept;
+    //can the cross section be evaluated on many threads at once
+    //models opt in once their matrix elements keep no shared state
+    virtual bool CanEvaluateConcurrently() const {return false;}
+
+    double get_s() const noexcept{ return Kin()._s; }
+    double get_t() const noexcept { return Kin()._t; }
+    double get_W() const noexcept { return Kin()._W; }
+    double get_Q2() const noexcept { return Kin()._Q2>=0 ? Kin()._Q2 : -_photon->M2(); }
 
   
     double kinCM_MesonP(double W) const {
@@ -144,29 +204,42 @@ namespace elSpectro{
 
     double dsigma_costh(double cosTh){
       //For integrating cross section
-      _W = Parent()->P4().M();
-      _s=_W*_W;
-      _t = kin_tFromWCosTh(cosTh);
+      auto& kin=Kin();
+      kin._W = Parent()->P4().M();
+      kin._s=kin._W*kin._W;
+      kin._t = kin_tFromWCosTh(cosTh);
       // std::cout<<"dsigma_costh t "<<_t<<" "<<PhaseSpaceFactorCosTh()<<" "<<MatrixElementsSquared_T()<<std::endl;
   
       return PhaseSpaceFactorCosTh()*(MatrixElementsSquared_T()+(_photonPol->Epsilon()+_photonPol->Delta())*MatrixElementsSquared_L()) ;//2pi=>integrated over phi
     }
     double dsigma_costhW(double cosTh,double W){
      //For integrating cross section
-      _W = W;
-      _s=_W*_W;
-      _t = kin_tFromWCosTh(cosTh);
+      auto& kin=Kin();
+      kin._W = W;
+      kin._s=W*W;
+      kin._t = kin_tFromWCosTh(cosTh);
       return PhaseSpaceFactorCosTh()*(MatrixElementsSquared_T()+(_photonPol->Epsilon()+_photonPol->Delta())*MatrixElementsSquared_L()) ;//2pi=>integrated over phi
     }
+    //as dsigma_costhW for a virtual photon Q2 with epsilon+delta=epsDelta,
+    //uses its own kinematics so may be called from many threads
+    double dsigma_costhWQ2(double cosTh,double W,double Q2,double epsDelta) const;
 
   private:
 
+    bool SetEventKinematics() const;
+
     double DifferentialXSect() const{//dont let others call this as need _s, _W and _t set
       //Note if your derived model already gives differential cross section
       //you will need to divide by PhaseSpaceFactor to get MatrixElementSquared from it
       // std::cout<<" DifferentialXSect() "<<PhaseSpaceFactor()<<"  "<<" "<<PgammaCMsq()<<std::endl;
-      return _dsigma=PhaseSpaceFactor() *
-	( MatrixElementsSquared_T() + (_photonPol->Epsilon()+_photonPol->Delta())*MatrixElementsSquared_L()); //eqn from Seyboth and Wolf
+      double meT=0;
+      double meL=0;
+      if(GridMatrixElements(meT,meL)==false){
+	meT=MatrixElementsSquared_T();
+	meL=MatrixElementsSquared_L();
+      }
+      return PhaseSpaceFactor() *
+	( meT + (_photonPol->Epsilon()+_photonPol->Delta())*meL); //eqn from Seyboth and Wolf
     }
        
     SDME* _sdmeMeson={nullptr};
@@ -181,13 +254,18 @@ namespace elSpectro{
     LorentzVector* _photon={nullptr};
     LorentzVector* _target={nullptr};//{0,0,0,escat::M_pr()};
     const LorentzVector* _ebeam={nullptr};//{0,0,0,escat::M_pr()};
+
+    std::unique_ptr<InterpolationGrid> _grid;//!
+    std::vector<int> _gridPoints;
+    mutable std::vector<double> _gridSDMEs;//!
+    bool _gridMass={false};
+    std::unique_ptr<InterpolationGrid> _squeeze;//!
+    std::vector<int> _squeezePoints;
+    bool _squeezeMass={false};
  
     mutable double _max={0};
-    mutable double _s={0};
-    mutable double _t={0};
-    mutable double _W={0};
+    mutable STKinematics _kin;//!
     mutable double _dt={0};
-    mutable double _dsigma={0};
     double _Wmax={0};
  
     bool _useSDME={false};
@@ -1,6 +1,7 @@
 #include "DecayModelst0.h"
 #include "SDMEDecay.h"
 #include "FunctionsForGenvector.h"
+#include "FunctionsForMaximisation.h"
 #include <TDatabasePDG.h>
 #include <Math/GSLIntegrator.h>
 #include <Math/IntegrationTypes.h>
@@ -81,9 +82,6 @@ namespace elSpectro{
   
     double weight = DifferentialXSect() * _dt ;//must multiply by t-range for correct sampling
   
-    CalcMesonSDMEs();
-    CalcBaryonSDMEs();
-
     weight/=_max; //normalise range 0-1
     weight/= TMath::Sqrt(PgammaCMsq()/kine::PDK2(_W,0,_target->M())); //correct max for finite Q2 phase space
  
@@ -106,6 +104,8 @@ namespace elSpectro{
     
   }
   
+  ///Maximum of dsigma/dt*(t range) over W and cos(theta) from a
+  ///grid search seeding local fits, also done for the minimum meson mass
   double DecayModelst0::FindMaxOfIntensity(){
     
     auto M1 = 0;//assum real photon for max calculation
@@ -139,94 +139,36 @@ namespace elSpectro{
 
 	double val = DifferentialXSect()*dt;
 	if( TMath::IsNaN(val) ) return 0.;
-	return -(val); //using a minimiser!
+	return val;
       };
-   
-      //First perform grid search for intital values
-      double Wrange=_Wmax-Wmin;
-      double tmax=kine::tmax(_Wmax,M1,M2,M3,M4);
-       
-      double gridMin=0;
-      double gridW=0;
-      double gridt=0;
-      double WtVals[2];
-   
-      ROOT::Math::Minimizer* minimum =
-	ROOT::Math::Factory::CreateMinimizer("Genetic", "");
-      //	ROOT::Math::Factory::CreateMinimizer("Minuit2", "Combined");
 
-      if(minimum==nullptr) //Minuit2 not always installed!
-	minimum = ROOT::Math::Factory::CreateMinimizer("Minuit", "");
-      
-      // set tolerance , etc...
-      minimum->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2
-      minimum->SetMaxIterations(1000);  // for GSL
-      minimum->SetTolerance(0.0001);
-      minimum->SetPrintLevel(0);
-      
-      // create function wrapper for minimizer
-      // a IMultiGenFunction type
-      ROOT::Math::Functor wrapf(Fmax,2);
+    //variable 0 = W, variable 1 = cos(theta)
+    //_s,_t and _W are shared so evaluate on this thread only
+    auto findMax=[&](){
+      auto result = maximise::multiStart(Fmax,{Wmin,-1},{_Wmax,1},50,8,false);
+      auto maxW=result._x[0];
+      std::cout << "Maximum : Probabiltiy Dist at ( W=" << maxW << " , t = "  << kine::tFromcosthW(result._x[1],maxW,M1,M2,M3,M4) << "): "<< result._max << " bound "<<result._bound<<" (fits gained up to "<<result._margin*100<<"% on grid) note t0 "<<kine::t0(maxW,M1,M2,M3,M4)<< std::endl;
+      return result._bound;
+    };
 
-      //variable = W, variable 1 = t
-      // double step[2] = {Wrange/500,0.001};
-      double step[2] = {Wrange/100,2./100};
-      // starting point
-      
-      // double variable[2] = { gridW,gridt};
-      double variable[2] = {Wmin+Wrange/2,0};
-      
-      minimum->SetFunction(wrapf);
-      
-      // Set the free variables to be minimized !
-      minimum->SetVariable(0,"W",variable[0], step[0]);
-      minimum->SetVariable(1,"t",variable[1], step[1]);
-      // minimum->SetVariableLimits(0,Wmin,_Wmax);
-      // minimum->SetVariableLimits(1,tmax,0);
+    auto maxVal=findMax();
 
-      // do the minimization
-      minimum->Minimize();
-      const double *xs = minimum->X();
- 
-      auto minVal = minimum->MinValue();
-      auto minW= xs[0];
-      auto mint= kine::tFromcosthW(xs[1],minW,M1,M2,M3,M4);//xs[1];
-   
-      std::cout << "Maximum : Probabiltiy Dist at ( W=" << minW << " , t = "  << mint << "): "<< -minimum->MinValue()  << " note t0 "<<kine::t0(minW,M1,M2,M3,M4)<< std::endl;
+    //check for low mass meson limits
+    if(dynamic_cast<DecayingParticle*>(_meson)){ //meson
+      dynamic_cast<DecayingParticle*>(_meson)->TakeMinimumMass();//to get threshold behaviour
+      M3=_meson->Mass();
 
-      //check for low mass meson limits
-      if(dynamic_cast<DecayingParticle*>(_meson)){ //meson
-	dynamic_cast<DecayingParticle*>(_meson)->TakeMinimumMass();//to get threshold behaviour
-	M3=_meson->Mass();
-	
-	// do the minimization at min mass in case higher max
-	minimum->Minimize();
-	const double *xs = minimum->X();
-	
-	auto minminVal = minimum->MinValue();
-	
-
-	if(minminVal<minVal){
-	  std::cout << "Minimum Mass Maximum : Probabiltiy Dist at ( W=" << minW << " , t = "  << mint << "): "<< -minimum->MinValue()<< " note t0 "<<kine::t0(minW,M1,M2,M3,M4)  << std::endl;
-	  std::cout<<"minmin "<<-minminVal<<" < "<<-minVal<<std::endl;
-	  minVal=minminVal;
-	  minW= xs[0];
-	  mint= xs[1];
-	}
-	//back to PDg mass if exists
-	if(_meson->PdgMass()>M3)
-	  M3=_meson->PdgMass();
-	  dynamic_cast<DecayingParticle*>(_meson)->TakePdgMass();
-
-      }
-
-      if(gridMin<minVal){
-	Warning("DecayModelst0::FindMaxOfIntensity()","grid search value already bigger than minimised, so will revert to that max value +5 percent");
-	std::cout<<"gridMin "<<gridMin<<" "<<minVal<<std::endl;
-	minVal=gridMin*1.05;
+      // do the maximisation at min mass in case higher max
+      auto minMassVal=findMax();
+      if(minMassVal>maxVal){
+	std::cout<<"DecayModelst0::FindMaxOfIntensity() minimum meson mass max "<<minMassVal<<" > "<<maxVal<<std::endl;
+	maxVal=minMassVal;
       }
+      //back to PDg mass
+      dynamic_cast<DecayingParticle*>(_meson)->TakePdgMass();
+    }
 
-      return -minVal;
+    return maxVal;
   }
   /*
   void DecayModelst0::HistIntegratedXSection(TH1D& hist){
@@ -31,6 +31,10 @@ namespace elSpectro{
     
     //
     double Intensity() const override; //this should perhaps be final so derived classes cannot overwrite...
+    void PostAccept() const override{
+      CalcMesonSDMEs();
+      CalcBaryonSDMEs();
+    }
     
     void PostInit(ReactionInfo* info) override;
 
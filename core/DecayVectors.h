@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Particle.h"
+#include "ThreadRandom.h"
 #include "DecayModel.h"
 #include <Math/RotationZYX.h>
 #include <Math/RotationZ.h>
@@ -42,6 +43,10 @@ namespace elSpectro{
 
     virtual double Probability() const {return 1;}
 
+    //weight of the last Generate if it kept a sample its
+    //accept/reject would have thrown, see Manager::SetWeightedEvents
+    virtual double EnvelopeWeight() const {return 1;}
+
 
 
    virtual void BoostToParentWithRandPhi(const LorentzVector& parent, LorentzVector& child){
@@ -72,7 +77,7 @@ namespace elSpectro{
   protected:
     
     mutable double _weight={1};
-    virtual double RandomPhi() const noexcept { return gRandom->Uniform(-TMath::Pi(),TMath::Pi()); }
+    virtual double RandomPhi() const noexcept { return rng().Uniform(-TMath::Pi(),TMath::Pi()); }
  
      
   private:
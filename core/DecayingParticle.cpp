@@ -2,7 +2,7 @@
 #include "TwoBodyFlat.h"
 #include "Manager.h"
 #include "Interface.h"
-#include <TRandom.h>
+#include "ThreadRandom.h"
 #include <TDatabasePDG.h>
 
 namespace elSpectro{
@@ -30,9 +30,7 @@ namespace elSpectro{
       double meanFreePath=lifetime*TMath::C()*1000; //in mm
       if( meanFreePath>0.1 ){ //0.1mm
     	_decayType=DecayType::Detached;
-	_decVertexDist = new DistTF1(TF1("MFP","TMath::Exp(-x/[0])",0,25*lifetime));//in mm
-	_decVertexDist->GetTF1().SetParameter(0,lifetime);
-	_decVertexDist->GetTF1().SetNpx(500);
+	_decVertexDist = new DistExponential(lifetime,0,25*lifetime);//in s
       }
       else _decayType=DecayType::Attached;
     }
@@ -70,6 +68,8 @@ namespace elSpectro{
     
     if(_decay)_decay->PostInit(info);
     if(_decayer)_decayer->PostInit(info);
+
+    _envelope.SetRange(MinimumMassPossible(),MaximumMassPossible());
  
     //std::cout<<"DecayingParticle::PostInit pdg "<<Pdg()<<" vertexID "<<_decayVertexID<<std::endl;
     // std::cout<<"DecayingParticle::PostInit  min mass "<<MinimumMassPossible()<<std::endl;
@@ -78,6 +78,7 @@ namespace elSpectro{
   DecayStatus   DecayingParticle::GenerateProducts(){
 
     _generateCalls++;
+    _envelopeWeight=1;
     
     if(Model()->CheckThreshold()==false) return DecayStatus::ReGenerate;
     
@@ -99,31 +100,82 @@ namespace elSpectro{
     //samplingWeight ==0 => not physical (below threshold)
     if(samplingWeight==0) return DecayStatus::ReGenerate;
   
-    //evaluate the model intensity for the product vectors
-    double weight = 1;
-    if(Model()!=nullptr)  weight = Model()->Intensity();
-    // std::cout<<"DecayingParticle::GenerateProducts "<<samplingWeight<<" "<<weight<<std::endl;
-    if(weight==0)  return DecayStatus::ReGenerate;
-    if(samplingWeight - weight < -1E-4 ){//tolerance 0.0001
-      std::cout<<"DecayingParticle::GenerateProducts model weight is greater than envelope " <<Mass()<<" "<<Model()->GetName()<<" "<<Class_Name()<<" weights "<<samplingWeight <<" "<<weight<<" masses "<<Model()->Products()[0]->Mass()<<" "<<Model()->Products()[1]->Mass()<<" difference in weights "<<samplingWeight-weight <<std::endl;
-    //exit(0);
+    auto& manager=Manager::Instance();
+    const bool weighted = manager.WeightedEvents() && RegeneratesOnFail();
+    //as for weighted, retries with a fixed parent are conditional on it
+    //so a raised envelope weight would change the parent distribution
+    const bool adaptive = manager.AdaptiveEnvelopes() && RegeneratesOnFail();
+    //plain accept/reject can draw the uniform first and skip the
+    //intensity when it falls under the model's lower bound (squeeze)
+    //or above its upper bound
+    double lower=0;
+    double upper=0;
+    const bool bounded = Model()!=nullptr && weighted==false && _sampledExternally==false
+      && adaptive==false && Model()->IntensityBounds(lower,upper);
+    if(bounded){
+      if(upper==0) return DecayStatus::ReGenerate;
+      auto u = rng().Uniform()*_maxWeight*samplingWeight;
+      if(u<lower){
+	++_squeezeAccepted;
+	decayed = true;
+      }
+      else if(u>=upper){
+	++_boundRejected;
+	decayed = false;
+      }
+      else{
+	auto weight = Model()->Intensity();
+	if(weight==0)  return DecayStatus::ReGenerate;
+	decayed = weight > u;
+      }
     }
-    //if event info use its weight, if not assume phse space model = 1.
-    weight/=samplingWeight;
+    else{
+      //evaluate the model intensity for the product vectors
+      double weight = 1;
+      if(Model()!=nullptr)  weight = Model()->Intensity();
+      // std::cout<<"DecayingParticle::GenerateProducts "<<samplingWeight<<" "<<weight<<std::endl;
+      if(weight==0)  return DecayStatus::ReGenerate;
+      if(adaptive==false && weighted==false && _sampledExternally==false
+         && samplingWeight - weight < -1E-4 ){//tolerance 0.0001
+        std::cout<<"DecayingParticle::GenerateProducts model weight is greater than envelope " <<Mass()<<" "<<Model()->GetName()<<" "<<Class_Name()<<" weights "<<samplingWeight <<" "<<weight<<" masses "<<Model()->Products()[0]->Mass()<<" "<<Model()->Products()[1]->Mass()<<" difference in weights "<<samplingWeight-weight <<std::endl;
+      //exit(0);
+      }
+      //if event info use its weight, if not assume phse space model = 1.
+      weight/=samplingWeight;
   
    
  
-    //accept/reject this decay
-    //if decay depends on variable chosen by parent need to regenerate on fail
-    //if decay indendent of parent variables can just try for another
-    // std::cout<<Pdg()<<" "<<weight <<" "<<_maxWeight<<" "<<samplingWeight<<std::endl;
-    decayed = weight > gRandom->Uniform()*_maxWeight ;
+      //accept/reject this decay
+      //if decay depends on variable chosen by parent need to regenerate on fail
+      //if decay indendent of parent variables can just try for another
+      // std::cout<<Pdg()<<" "<<weight <<" "<<_maxWeight<<" "<<samplingWeight<<std::endl;
+      if(_sampledExternally){
+        _envelopeWeight = 1;
+        decayed = true;
+      }
+      else if(weighted){
+        //keep the decay and carry its ratio in the event weight
+        //retries with a fixed parent are conditional on it so
+        //they stay accept/reject, their ratio is not normalised
+        _envelopeWeight = weight/_maxWeight;
+        decayed = true;
+      }
+      else if(adaptive){
+        //raise envelope if exceeded and correct with event weight
+        _envelopeWeight = _envelope.AcceptReject(Mass(),weight/_maxWeight,rng().Uniform(),manager.GetNDone());
+        decayed = _envelopeWeight > 0;
+      }
+      else decayed = weight > rng().Uniform()*_maxWeight ;
+    }
     if (decayed == false && (Model()->RegenerateOnFail()==false) )
       return DecayStatus::TryAnother;
     else if (decayed == false && (Model()->RegenerateOnFail()==true) )
       return DecayStatus::ReGenerate;
 
     //else true
+    //decayer may have skipped its own accept/reject
+    _envelopeWeight*=_decayer->EnvelopeWeight();
+    if(Model()!=nullptr) Model()->PostAccept();
 
     //decay vertex position
     GenerateVertexPosition();
@@ -154,6 +206,9 @@ namespace elSpectro{
   void DecayingParticle::Print() const {
     Particle::Print();
     std::cout<<"\t DecayParticle GenerateProducts calls "<<_generateCalls<<std::endl;
+    if(_squeezeAccepted+_boundRejected>0)
+      std::cout<<"\t decided without intensity, accepted under squeeze "<<_squeezeAccepted<<" rejected above bound "<<_boundRejected<<std::endl;
+    _envelope.Print("DecayParticle");
     if(Model()) Model()->Print();
     
   }
@@ -15,6 +15,8 @@
 #include "TwoBodyFlat.h"
 #include "ReactionInfo.h"
 #include "DistTF1.h"
+#include "DistExponential.h"
+#include "EnvelopeAdaptor.h"
 
 namespace elSpectro{
   
@@ -80,6 +82,9 @@ namespace elSpectro{
     void TakePdgMass(){
       SetP4M( PdgMass() );
     }
+    void TakeMass(double mass){
+      SetP4M( mass );
+    }
     void Print() const override;
 
 
@@ -103,10 +108,27 @@ namespace elSpectro{
     void SetVertexXYZT(double x,double y,double z,double t){
       _decayVertex.SetXYZT(x,y,z,t);
     }
+
+    //weight of the last accepted decay, 1 unless adaptive envelopes
+    //are on and the model intensity exceeded its envelope, or
+    //weighted events are on and the decay was not accept/rejected
+    double EnvelopeWeight()const noexcept{return _envelopeWeight;}
+    const EnvelopeAdaptor& Envelope()const noexcept{return _envelope;}
+
+    //decay variables come from a sampler which already follows the
+    //intensity, e.g. ElectronScattering::UseFoam, so always accept
+    void SetSampledExternally(bool ext=true){_sampledExternally=ext;}
+
+    //decays decided by the model intensity bounds alone
+    long NSqueezeAccepted()const noexcept{return _squeezeAccepted;}
+    long NBoundRejected()const noexcept{return _boundRejected;}
     
   protected:
     
     DecayVectors* mutableDecayer() const {return _decayer.get();}
+    //true if a rejected decay regenerates the whole event
+    //rather than retrying with the same parent
+    virtual bool RegeneratesOnFail() const {return Model()->RegenerateOnFail();}
 
 
   private:
@@ -114,7 +136,10 @@ namespace elSpectro{
     DecayModel* _decay={nullptr}; //not owner
     
     std::unique_ptr<DecayVectors> _decayer={nullptr}; //owner
-    DistTF1* _decVertexDist=nullptr;//! needed if detached vertex
+    DistExponential* _decVertexDist=nullptr;//! needed if detached vertex
+    EnvelopeAdaptor _envelope;//! bins in my mass
+    double _envelopeWeight={1};//!
+    bool _sampledExternally={false};//!
     
     double _minMass={0};
     LorentzVector _decayVertex;
@@ -122,6 +147,8 @@ namespace elSpectro{
     DecayType _decayType;
 
     long _generateCalls={0};
+    long _squeezeAccepted={0};//!
+    long _boundRejected={0};//!
     
     ClassDefOverride(elSpectro::DecayingParticle,1); //class DecayingParticle
     
@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		DistBreitWigner
+///Description:
+///             Non-relativistic Breit-Wigner (Cauchy) mass distribution
+///             with values as TMath::BreitWigner(x,mass,width)
+///             The CDF is an arctan so it is inverted exactly,
+///             SampleSingle(xmin,xmax) maps u between the arctan of
+///             the limits, no table is needed
+///             e.g.
+///             mass_distribution(113,new DistBreitWigner{0.775,0.151,0.2,0.7});
+
+#pragma once
+
+#include "Distribution.h"
+#include "ThreadRandom.h"
+#include <TMath.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  class DistBreitWigner : public Distribution {
+
+    
+  public :
+
+    DistBreitWigner(double mass,double width,double xmin,double xmax):
+      _mass{mass},_width{width},_xmin{xmin},_xmax{xmax}{
+      if(_width<=0 || _xmax<=_xmin){
+	std::cerr<<"DistBreitWigner::DistBreitWigner need positive width and range, exiting..."<<std::endl;
+	exit(0);
+      }
+      _max_val=Value(std::clamp(_mass,_xmin,_xmax));
+      _min_val=std::min(Value(_xmin),Value(_xmax));
+    }
+ 
+    double SampleSingle()   noexcept final {
+      return SampleSingle(_xmin,_xmax);
+    }
+    double SampleSingle(double xmin,double xmax)   noexcept final {
+      xmin=std::max(xmin,_xmin);
+      xmax=std::min(xmax,_xmax);
+      if(xmax<=xmin) return _x=xmin;
+      auto amin=std::atan(2*(xmin-_mass)/_width);
+      auto amax=std::atan(2*(xmax-_mass)/_width);
+      _x=_mass+_width/2*std::tan(amin+rng().Uniform()*(amax-amin));
+      _x=std::clamp(_x,xmin,xmax);
+      return _x;
+    }
+    
+    dist_pair SamplePair()   noexcept final {return dist_pair{0,0};} ;
+
+    double CurrentValue() const noexcept final {return Value(_x);}
+    double MaxValue() const noexcept final {return _max_val;}
+    double MinValue() const noexcept final {return _min_val;}
+
+    double GetX() const noexcept { return _x;}
+    
+    double GetMinX() const noexcept final{return _xmin;}
+    double GetMaxX() const noexcept final{return _xmax;}
+
+    double GetValueFor(double valX,double valY=0) final {return Value(valX);}
+    
+  private:
+    double Value(double x) const noexcept{
+      return TMath::BreitWigner(x,_mass,_width);
+    }
+
+    //no one should use default constructor
+    DistBreitWigner()=default;
+
+    double _mass{0};
+    double _width{0};
+    double _xmin{0};
+    double _xmax{0};
+    double _x{0};
+    double _max_val{0};
+    double _min_val{0};
+    
+    ClassDef(elSpectro::DistBreitWigner,1); //class Distribution
+ 
+
+  };
+
+}
@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		DistExponential
+///Description:
+///             Exponential decay distribution exp(-x/tau) on [xmin,xmax]
+///             e.g. decay time or length of a detached vertex
+///             The truncated CDF is inverted exactly,
+///             x = xmin - tau*ln(1 - u*(1-exp(-(xmax-xmin)/tau)))
+///             xmax may be infinite
+///             e.g.
+///             auto dist = DistExponential{lifetime,0,25*lifetime};
+
+#pragma once
+
+#include "Distribution.h"
+#include "ThreadRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  class DistExponential : public Distribution {
+
+    
+  public :
+
+    DistExponential(double tau,double xmin,double xmax):
+      _tau{tau},_xmin{xmin},_xmax{xmax}{
+      if(_tau<=0 || _xmax<=_xmin){
+	std::cerr<<"DistExponential::DistExponential need positive tau and range, exiting..."<<std::endl;
+	exit(0);
+      }
+      _max_val=Value(_xmin);
+      _min_val=Value(_xmax);
+    }
+ 
+    double SampleSingle()   noexcept final {
+      return SampleSingle(_xmin,_xmax);
+    }
+    double SampleSingle(double xmin,double xmax)   noexcept final {
+      xmin=std::max(xmin,_xmin);
+      xmax=std::min(xmax,_xmax);
+      if(xmax<=xmin) return _x=xmin;
+      //fraction of exp(-x/tau) from xmin lying below xmax
+      auto frac=-std::expm1(-(xmax-xmin)/_tau);
+      _x=xmin-_tau*std::log1p(-rng().Uniform()*frac);
+      _x=std::clamp(_x,xmin,xmax);
+      return _x;
+    }
+    
+    dist_pair SamplePair()   noexcept final {return dist_pair{0,0};} ;
+
+    double CurrentValue() const noexcept final {return Value(_x);}
+    double MaxValue() const noexcept final {return _max_val;}
+    double MinValue() const noexcept final {return _min_val;}
+
+    double GetX() const noexcept { return _x;}
+    
+    double GetMinX() const noexcept final{return _xmin;}
+    double GetMaxX() const noexcept final{return _xmax;}
+
+    double GetValueFor(double valX,double valY=0) final {return Value(valX);}
+
+    double GetTau() const noexcept{return _tau;}
+    
+  private:
+    double Value(double x) const noexcept{
+      return std::exp(-x/_tau);
+    }
+
+    //no one should use default constructor
+    DistExponential()=default;
+
+    double _tau{1};
+    double _xmin{0};
+    double _xmax{0};
+    double _x{0};
+    double _max_val{0};
+    double _min_val{0};
+    
+    ClassDef(elSpectro::DistExponential,1); //class Distribution
+ 
+
+  };
+
+}
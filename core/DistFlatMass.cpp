@@ -1,4 +1,5 @@
 #include "DistFlatMass.h"
+#include "ThreadRandom.h"
 
 namespace elSpectro{
 
@@ -47,7 +48,7 @@ namespace elSpectro{
       
       int nrand=_size;
       double randArray[nrand];
-      gRandom->RndmArray(nrand,randArray);
+      rng().RndmArray(nrand,randArray);
       //Sorting gives factor 2 speed up (probably due to unphysical values being found earlier)
       if(nrand>1)std::sort(randArray,randArray + nrand);
 
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		DistGaussian
+///Description:
+///             Gaussian distribution e.g. for beam energy spread
+///             values as TMath::Gaus(x,mean,sigma)
+///             Samples by inverting the normal CDF between the
+///             CDF of the limits, so truncated ranges cost no
+///             rejections. Ranges in the upper tail use the
+///             complement of the CDF to keep precision
+///             Default range is mean +- 10 sigma
+///             e.g.
+///             auto spread = DistGaussian{10.,0.01};
+
+#pragma once
+
+#include "Distribution.h"
+#include "ThreadRandom.h"
+#include <Math/ProbFuncMathCore.h>
+#include <Math/QuantFuncMathCore.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  class DistGaussian : public Distribution {
+
+    
+  public :
+
+    DistGaussian(double mean,double sigma):
+      DistGaussian(mean,sigma,mean-10*sigma,mean+10*sigma){}
+    
+    DistGaussian(double mean,double sigma,double xmin,double xmax):
+      _mean{mean},_sigma{sigma},_xmin{xmin},_xmax{xmax}{
+      if(_sigma<=0 || _xmax<=_xmin){
+	std::cerr<<"DistGaussian::DistGaussian need positive sigma and range, exiting..."<<std::endl;
+	exit(0);
+      }
+      _max_val=Value(std::clamp(_mean,_xmin,_xmax));
+      _min_val=std::min(Value(_xmin),Value(_xmax));
+    }
+ 
+    double SampleSingle()   noexcept final {
+      return SampleSingle(_xmin,_xmax);
+    }
+    double SampleSingle(double xmin,double xmax)   noexcept final {
+      xmin=std::max(xmin,_xmin);
+      xmax=std::min(xmax,_xmax);
+      if(xmax<=xmin) return _x=xmin;
+      auto zmin=(xmin-_mean)/_sigma;
+      auto zmax=(xmax-_mean)/_sigma;
+      auto u=rng().Uniform();
+      double z=0;
+      if(zmin>0){
+	auto qmin=ROOT::Math::normal_cdf_c(zmin);
+	auto qmax=ROOT::Math::normal_cdf_c(zmax);
+	z=ROOT::Math::normal_quantile_c(qmin-u*(qmin-qmax),1);
+      }
+      else{
+	auto pmin=ROOT::Math::normal_cdf(zmin);
+	auto pmax=ROOT::Math::normal_cdf(zmax);
+	z=ROOT::Math::normal_quantile(pmin+u*(pmax-pmin),1);
+      }
+      _x=std::clamp(_mean+z*_sigma,xmin,xmax);
+      return _x;
+    }
+    
+    dist_pair SamplePair()   noexcept final {return dist_pair{0,0};} ;
+
+    double CurrentValue() const noexcept final {return Value(_x);}
+    double MaxValue() const noexcept final {return _max_val;}
+    double MinValue() const noexcept final {return _min_val;}
+
+    double GetX() const noexcept { return _x;}
+    
+    double GetMinX() const noexcept final{return _xmin;}
+    double GetMaxX() const noexcept final{return _xmax;}
+
+    double GetValueFor(double valX,double valY=0) final {return Value(valX);}
+    
+  private:
+    double Value(double x) const noexcept{
+      auto z=(x-_mean)/_sigma;
+      return std::exp(-0.5*z*z);
+    }
+
+    //no one should use default constructor
+    DistGaussian()=default;
+
+    double _mean{0};
+    double _sigma{1};
+    double _xmin{0};
+    double _xmax{0};
+    double _x{0};
+    double _max_val{0};
+    double _min_val{0};
+    
+    ClassDef(elSpectro::DistGaussian,1); //class Distribution
+ 
+
+  };
+
+}
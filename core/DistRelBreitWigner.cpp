@@ -0,0 +1,58 @@
+#include "DistRelBreitWigner.h"
+#include <TMath.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  DistRelBreitWigner::DistRelBreitWigner(double mass,double width,double m1,double m2,int L,double xmin,double xmax):
+    _mass{mass},_width{width},_m1{m1},_m2{m2},_xmin{xmin},_xmax{xmax},_L{L}{
+
+    //nothing below threshold
+    _xmin=std::max(_xmin,_m1+_m2);
+    _q0=BreakupMomentum(_mass);
+    if(_width<=0 || _q0<=0 || _xmax<=_xmin){
+      std::cerr<<"DistRelBreitWigner::DistRelBreitWigner need positive width, mass above m1+m2 and range, exiting..."<<std::endl;
+      exit(0);
+    }
+    
+    //nodes are added where the peak is not resolved
+    int ninit=std::max(1000,static_cast<int>(20*(_xmax-_xmin)/_width));
+    _table.Build([this](double m){return Value(m);},_xmin,_xmax,ninit);
+
+    //peak is near mass, the scan is for wide states where it is pulled
+    //by the energy dependence of the width
+    const int nscan=10000;
+    _max_val=Value(std::clamp(_mass,_xmin,_xmax));
+    _min_val=_max_val;
+    for(int i=0;i<=nscan;++i){
+      auto val=Value(_xmin+(_xmax-_xmin)*i/nscan);
+      _max_val=std::max(_max_val,val);
+      _min_val=std::min(_min_val,val);
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  ///momentum of m1 in the rest frame of m
+  double DistRelBreitWigner::BreakupMomentum(double m) const noexcept{
+    auto m2=m*m;
+    auto arg=(m2-(_m1+_m2)*(_m1+_m2))*(m2-(_m1-_m2)*(_m1-_m2));
+    if(arg<=0) return 0;
+    return std::sqrt(arg)/(2*m);
+  }
+  ///////////////////////////////////////////////////////////
+  double DistRelBreitWigner::Width(double m) const noexcept{
+    if(m<=0) return 0;
+    auto q=BreakupMomentum(m);
+    return _width*_mass/m*TMath::Power(q/_q0,2*_L+1);
+  }
+  ///////////////////////////////////////////////////////////
+  double DistRelBreitWigner::Value(double m) const noexcept{
+    auto gamma=Width(m);
+    if(gamma<=0) return 0;
+    auto dm2=m*m-_mass*_mass;
+    auto mg=_mass*gamma;
+    return 2*m/TMath::Pi()*mg/(dm2*dm2+mg*mg);
+  }
+
+}
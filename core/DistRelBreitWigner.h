@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		DistRelBreitWigner
+///Description:
+///             Relativistic Breit-Wigner mass distribution with
+///             energy dependent width for a decay to masses m1,m2
+///             with orbital angular momentum L
+///             Gamma(m) = width * mass/m * (q(m)/q(mass))^(2L+1)
+///             f(m) = 2m/pi * mass*Gamma(m) / ((m^2-mass^2)^2 + mass^2*Gamma(m)^2)
+///             which is zero below m1+m2 and close to TMath::BreitWigner
+///             for narrow states
+///             The CDF has no closed form so it is tabulated once
+///             when constructed, samples invert the table
+///             e.g.
+///             mass_distribution(113,new DistRelBreitWigner{0.775,0.149,0.1396,0.1396,1,0.2,1.5});
+
+#pragma once
+
+#include "Distribution.h"
+#include "ThreadRandom.h"
+#include "InverseCDFTable.h"
+
+namespace elSpectro{
+
+  class DistRelBreitWigner : public Distribution {
+
+    
+  public :
+
+    DistRelBreitWigner(double mass,double width,double m1,double m2,int L,double xmin,double xmax);
+ 
+    double SampleSingle()   noexcept final {
+      _x=_table.Sample(rng().Uniform());
+      return _x;
+    }
+    double SampleSingle(double xmin,double xmax)   noexcept final {
+      _x=_table.Sample(xmin,xmax,rng().Uniform());
+      return _x;
+    }
+    
+    dist_pair SamplePair()   noexcept final {return dist_pair{0,0};} ;
+
+    double CurrentValue() const noexcept final {return Value(_x);}
+    double MaxValue() const noexcept final {return _max_val;}
+    double MinValue() const noexcept final {return _min_val;}
+
+    double GetX() const noexcept { return _x;}
+    
+    double GetMinX() const noexcept final{return _xmin;}
+    double GetMaxX() const noexcept final{return _xmax;}
+
+    double GetValueFor(double valX,double valY=0) final {return Value(valX);}
+
+    double Width(double m) const noexcept;
+    
+  private:
+    //no one should use default constructor
+    DistRelBreitWigner()=default;
+
+    double Value(double m) const noexcept;
+    double BreakupMomentum(double m) const noexcept;
+
+    InverseCDFTable _table;//!
+    double _mass{0};
+    double _width{0};
+    double _m1{0};
+    double _m2{0};
+    double _q0{0};
+    double _xmin{0};
+    double _xmax{0};
+    double _x{0};
+    double _max_val{0};
+    double _min_val{0};
+    int _L{0};
+    
+    ClassDef(elSpectro::DistRelBreitWigner,1); //class Distribution
+ 
+
+  };
+
+}
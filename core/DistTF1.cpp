@@ -1,5 +1,6 @@
 #include "DistTF1.h"
 #include "TH1.h"
+#include <algorithm>
 namespace elSpectro{
 
   DistTF1::DistTF1(const TF1& ff):
@@ -7,6 +8,25 @@ namespace elSpectro{
     _max_val = _tf1.GetMaximum();
     _min_val = _tf1.GetMinimum();
     _tf1.SetNpx(1E4);
+    //table is built when first sampled, the range may still change
+  }
+  ///////////////////////////////////////////////////////////
+  ///uses the TF1 range, Npx gives the starting number of nodes
+  void DistTF1::UpdateTable(){
+    _tableMin=_tf1.GetXmin();
+    _tableMax=_tf1.GetXmax();
+    _tableParams.assign(_tf1.GetParameters(),_tf1.GetParameters()+_tf1.GetNpar());
+    _max_val = _tf1.GetMaximum(_tableMin,_tableMax);
+    _min_val = _tf1.GetMinimum(_tableMin,_tableMax);
+    _table.Build([this](double x){return _tf1.Eval(x);},
+		 _tableMin,_tableMax,_tf1.GetNpx());
+  }
+  ///////////////////////////////////////////////////////////
+  bool DistTF1::TableIsStale() const noexcept{
+    if(_table.Empty()) return true;
+    if(_tf1.GetXmin()!=_tableMin || _tf1.GetXmax()!=_tableMax) return true;
+    if(static_cast<int>(_tableParams.size())!=_tf1.GetNpar()) return true;
+    return std::equal(_tableParams.begin(),_tableParams.end(),_tf1.GetParameters())==false;
   }
   double DistTF1::GetMinX() const noexcept{
 
@@ -3,13 +3,21 @@
 ///Class:		DistTF1
 ///Description:
 ///             wrapper for TF1 distributions
-/// 
+///             Samples by inverting a cumulative table of the function
+///             built once over its range, so SampleSingle(xmin,xmax)
+///             with a different range each event costs a binary search
+///             rather than TF1::GetRandom recomputing its integral
+///             The table is rebuilt when the range or parameters of
+///             the TF1 have changed since, e.g. after GetTF1().SetRange()
 
 #pragma once
 
 #include "Distribution.h"
+#include "ThreadRandom.h"
+#include "InverseCDFTable.h"
 #include <TF1.h>
 #include <string>
+#include <vector>
 
 namespace elSpectro{
 
@@ -21,12 +29,14 @@ namespace elSpectro{
     DistTF1(const TF1& ff);
  
     double SampleSingle()   noexcept final {
-      _x=_tf1.GetRandom();
+      if(TableIsStale()) UpdateTable();
+      _x=_table.Sample(rng().Uniform());
       _val=_tf1.Eval(_x);
       return _x;
     }
     double SampleSingle(double xmin,double xmax)   noexcept final {
-      _x=_tf1.GetRandom(xmin,xmax);
+      if(TableIsStale()) UpdateTable();
+      _x=_table.Sample(xmin,xmax,rng().Uniform());
       _val=_tf1.Eval(_x);
       return _x;
     }
@@ -46,12 +56,19 @@ namespace elSpectro{
     double GetValueFor(double valX,double valY=0) final {return _tf1.Eval(valX);}
     
     TF1& GetTF1()  noexcept {return _tf1;}
+    //build the table for the current range and parameters
+    void UpdateTable();
+    bool TableIsStale() const noexcept;
     
   private:
     //no one should use default constructor
     DistTF1()=default;
 
     TF1 _tf1;
+    InverseCDFTable _table;//!
+    std::vector<double> _tableParams;//! TF1 parameters of the table
+    double _tableMin{0};//!
+    double _tableMax{0};//!
     double _val{0};
     double _x{0};
     double _max_val{0};
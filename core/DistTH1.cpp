@@ -1,31 +1,91 @@
 #include "DistTH1.h"
+#include "FunctionsForSampling.h"
+#include <algorithm>
+
 namespace elSpectro{
 
   DistTH1::DistTH1(const TH1D& ff):
     _th1{ff}{
     _max_val = ff.GetMaximum();
     _min_val = ff.GetMinimum();
- 
-  }
-  double DistTH1::GetMinX() const noexcept{
 
+    //limits of non-zero bins, found once
     Int_t ib=0;
     for(ib=1;ib<_th1.GetNbinsX();ib++){
      auto fval=_th1.GetBinContent(ib);
      if(fval>0)break;
     }
-    
-    return _th1.GetBinLowEdge(ib);
-  }
-  double DistTH1::GetMaxX() const noexcept{
-    Int_t ib=0;
+    _minX=_th1.GetBinLowEdge(ib);
+
     for(ib=_th1.GetNbinsX(); ib>0 ;ib--){
      auto fval=_th1.GetBinContent(ib);
      if(fval>0)break;
     }
-    
-    return _th1.GetBinLowEdge(ib)+_th1.GetBinWidth(ib);
+    _maxX=_th1.GetBinLowEdge(ib)+_th1.GetBinWidth(ib);
+
+    BuildSampler();
+  }
+  ///////////////////////////////////////////////////////////
+  ///negative contents are not sampled, as TH1::GetRandom
+  void DistTH1::BuildSampler(){
+    const Int_t nbins=_th1.GetNbinsX();
+    _nodeX.resize(nbins+2);
+    _nodeVal.resize(nbins+2);
+    _nodeX[0]=_th1.GetBinLowEdge(1);
+    _nodeVal[0]=std::max(_th1.GetBinContent(1),0.);
+    for(Int_t ib=1;ib<=nbins;++ib){
+      _nodeX[ib]=_th1.GetBinCenter(ib);
+      _nodeVal[ib]=std::max(_th1.GetBinContent(ib),0.);
+    }
+    _nodeX[nbins+1]=_th1.GetBinLowEdge(nbins+1);
+    _nodeVal[nbins+1]=_nodeVal[nbins];
 
+    std::vector<double> weights;
+    if(_linearInBin){
+      weights.resize(nbins+1);
+      for(Int_t is=0;is<=nbins;++is)
+	weights[is]=(_nodeVal[is]+_nodeVal[is+1])/2*(_nodeX[is+1]-_nodeX[is]);
+    }
+    else{
+      weights.resize(nbins);
+      for(Int_t ib=1;ib<=nbins;++ib)
+	weights[ib-1]=_nodeVal[ib];
+    }
+    _binTable.Build(weights);
+  }
+  ///////////////////////////////////////////////////////////
+  double DistTH1::SampleSingle() noexcept{
+    auto& random=rng();
+    auto i=_binTable.Sample(random);
+    if(_linearInBin){
+      auto t=sampling::linearFraction(_nodeVal[i],_nodeVal[i+1],random.Uniform());
+      _x=_nodeX[i]+t*(_nodeX[i+1]-_nodeX[i]);
+    }
+    else
+      _x=_th1.GetBinLowEdge(i+1)+random.Uniform()*_th1.GetBinWidth(i+1);
+
+    _val=Interpolate(_x);
+    return _x;
+  }
+  ///////////////////////////////////////////////////////////
+  size_t DistTH1::FindSegment(double valX) const noexcept{
+    auto it=std::upper_bound(_nodeX.begin(),_nodeX.end(),valX);
+    if(it==_nodeX.begin()) return 0;
+    size_t is=(it-_nodeX.begin())-1;
+    return std::min(is,_nodeX.size()-2);
+  }
+  ///////////////////////////////////////////////////////////
+  ///outside of the first and last bin centres the end bin content
+  double DistTH1::Interpolate(double valX) const noexcept{
+    const auto n=_nodeX.size();
+    if(valX<=_nodeX[1]) return _th1.GetBinContent(1);
+    if(valX>=_nodeX[n-2]) return _th1.GetBinContent(n-2);
+    auto is=FindSegment(valX);
+    auto x0=_nodeX[is];
+    auto x1=_nodeX[is+1];
+    auto y0=_th1.GetBinContent(is);
+    auto y1=_th1.GetBinContent(is+1);
+    return y0 + (valX-x0)*((y1-y0)/(x1-x0));
   }
 
 }
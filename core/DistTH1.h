@@ -1,14 +1,20 @@
 //////////////////////////////////////////////////////////////
 ///
-///Class:		DistTF1
+///Class:		DistTH1
 ///Description:
 ///             wrapper for TH1 distributions
-/// 
+///             Bins are sampled from an alias table in constant time,
+///             then x is flat in the bin like TH1::GetRandom, or with
+///             SetLinearInBin() linear between bin centres, i.e. the
+///             same shape as GetValueFor (TH1::Interpolate)
 
 #pragma once
 
 #include "Distribution.h"
+#include "ThreadRandom.h"
+#include "AliasTable.h"
 #include <TH1.h>
+#include <vector>
 
 namespace elSpectro{
 
@@ -19,11 +25,7 @@ namespace elSpectro{
 
     DistTH1(const TH1D& ff);
  
-    double SampleSingle()  noexcept final {
-      _x=_th1.GetRandom();
-      _val=_th1.Interpolate(_x);
-      return _x;
-    }
+    double SampleSingle()  noexcept final;
     
     dist_pair SamplePair()   noexcept final {return dist_pair{0,0};} ;
 
@@ -33,12 +35,20 @@ namespace elSpectro{
 
     double GetX() const noexcept { return _x;}
     
-    double GetMinX() const noexcept final;
-    double GetMaxX() const noexcept final;
+    double GetMinX() const noexcept final{return _minX;}
+    double GetMaxX() const noexcept final{return _maxX;}
 
     //  double GetWeightFor(double valX)  {return  (static_cast<TH1D*>(&_th1))->GetBinContent((static_cast<TH1D*>(&_th1))->FindBin(valX))/_max_val;}
     // double GetWeightFor(double valX)  {return (static_cast<TH1D*>(&_th1))->Interpolate(valX)/_max_val;}
-    double GetValueFor(double valX,double valY=0) final  {return (static_cast<TH1D*>(&_th1))->Interpolate(valX);}
+    double GetValueFor(double valX,double valY=0) final  {return Interpolate(valX);}
+    //as TH1::Interpolate, linear between bin centres
+    double Interpolate(double valX) const noexcept;
+
+    //sample x linearly between bin centres rather than flat in bins
+    void SetLinearInBin(bool linear=true){
+      _linearInBin=linear;
+      BuildSampler();
+    }
     
     const TH1& GetTH1() const noexcept {return _th1;}
     void Draw(const TString& opt) { _th1.Draw(opt);}
@@ -47,11 +57,22 @@ namespace elSpectro{
     //no one should use default constructor
     DistTH1()=default;
 
+    void BuildSampler();
+    //index of node below x, nodes are the low edge, bin centres
+    //and the high edge, values of the end nodes are those of the end bins
+    size_t FindSegment(double valX) const noexcept;
+
     TH1D _th1;
+    std::vector<double> _nodeX;//!
+    std::vector<double> _nodeVal;//!
+    AliasTable _binTable;//! bins or segments between nodes if _linearInBin
     double _val{0};
     double _x{0};
     double _max_val{0};
     double _min_val{0};
+    double _minX{0};
+    double _maxX{0};
+    bool _linearInBin{false};
     
     ClassDef(elSpectro::DistTH1,1); //class Distribution
  
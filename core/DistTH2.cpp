@@ -1,4 +1,6 @@
 #include "DistTH2.h"
+#include "FunctionsForSampling.h"
+#include <algorithm>
 
 namespace elSpectro{
 
@@ -6,7 +8,123 @@ namespace elSpectro{
     _th2{ff}{
     _max_val = _th2.GetMaximum();
     _min_val = _th2.GetMinimum();
- 
+
+    BuildTables(false);
+  }
+  ///////////////////////////////////////////////////////////
+  ///copies made before this keep their tables
+  void DistTH2::SetBilinearInCell(bool bilinear){
+    if(_tables.get()!=nullptr && _tables->_bilinear==bilinear) return;
+    BuildTables(bilinear);
+  }
+  ///////////////////////////////////////////////////////////
+  ///negative contents are not sampled, as TH2::GetRandom2
+  void DistTH2::BuildTables(bool bilinear){
+    auto tables=std::make_shared<Tables>();
+    tables->_bilinear=bilinear;
+
+    const Int_t nbinsX=_th2.GetNbinsX();
+    const Int_t nbinsY=_th2.GetNbinsY();
+    auto makeNodes=[](const TAxis* axis,std::vector<double>& nodes){
+      const Int_t nbins=axis->GetNbins();
+      nodes.resize(nbins+2);
+      nodes[0]=axis->GetBinLowEdge(1);
+      for(Int_t ib=1;ib<=nbins;++ib) nodes[ib]=axis->GetBinCenter(ib);
+      nodes[nbins+1]=axis->GetBinUpEdge(nbins);
+    };
+    makeNodes(_th2.GetXaxis(),tables->_nodeX);
+    makeNodes(_th2.GetYaxis(),tables->_nodeY);
+
+    const size_t nnodeX=nbinsX+2;
+    const size_t nnodeY=nbinsY+2;
+    auto& nodeVal=tables->_nodeVal;
+    nodeVal.resize(nnodeX*nnodeY);
+    for(size_t iy=0;iy<nnodeY;++iy){
+      Int_t biny=std::min(std::max<Int_t>(iy,1),nbinsY);
+      for(size_t ix=0;ix<nnodeX;++ix){
+	Int_t binx=std::min(std::max<Int_t>(ix,1),nbinsX);
+	nodeVal[ix+iy*nnodeX]=_th2.GetBinContent(binx,biny);
+      }
+    }
+
+    std::vector<double> weights;
+    if(bilinear){
+      weights.resize((nnodeX-1)*(nnodeY-1));
+      for(size_t iy=0;iy<nnodeY-1;++iy)
+	for(size_t ix=0;ix<nnodeX-1;++ix){
+	  auto i00=ix+iy*nnodeX;
+	  auto corners=std::max(nodeVal[i00],0.)+std::max(nodeVal[i00+1],0.)
+	    +std::max(nodeVal[i00+nnodeX],0.)+std::max(nodeVal[i00+nnodeX+1],0.);
+	  weights[ix+iy*(nnodeX-1)]=corners/4
+	    *(tables->_nodeX[ix+1]-tables->_nodeX[ix])*(tables->_nodeY[iy+1]-tables->_nodeY[iy]);
+	}
+    }
+    else{
+      weights.resize(nbinsX*nbinsY);
+      for(Int_t iy=0;iy<nbinsY;++iy)
+	for(Int_t ix=0;ix<nbinsX;++ix)
+	  weights[ix+iy*nbinsX]=std::max(nodeVal[(ix+1)+(iy+1)*nnodeX],0.);
+    }
+    tables->_cells.Build(weights);
+
+    _tables=tables;
+  }
+  ///////////////////////////////////////////////////////////
+  dist_pair DistTH2::SamplePair() noexcept{
+    auto& random=rng();
+    const auto& tables=*_tables;
+    auto icell=tables._cells.Sample(random);
+
+    if(tables._bilinear){
+      const size_t nnodeX=tables._nodeX.size();
+      auto ix=icell%(nnodeX-1);
+      auto iy=icell/(nnodeX-1);
+      auto i00=ix+iy*nnodeX;
+      auto q00=std::max(tables._nodeVal[i00],0.);
+      auto q10=std::max(tables._nodeVal[i00+1],0.);
+      auto q01=std::max(tables._nodeVal[i00+nnodeX],0.);
+      auto q11=std::max(tables._nodeVal[i00+nnodeX+1],0.);
+      //x from the marginal of the patch, then y given x
+      auto tx=sampling::linearFraction(q00+q01,q10+q11,random.Uniform());
+      auto ty=sampling::linearFraction(q00+(q10-q00)*tx,q01+(q11-q01)*tx,random.Uniform());
+      _x=tables._nodeX[ix]+tx*(tables._nodeX[ix+1]-tables._nodeX[ix]);
+      _y=tables._nodeY[iy]+ty*(tables._nodeY[iy+1]-tables._nodeY[iy]);
+    }
+    else{
+      const Int_t nbinsX=_th2.GetNbinsX();
+      Int_t binx=icell%nbinsX+1;
+      Int_t biny=icell/nbinsX+1;
+      auto xaxis=_th2.GetXaxis();
+      auto yaxis=_th2.GetYaxis();
+      _x=xaxis->GetBinLowEdge(binx)+random.Uniform()*xaxis->GetBinWidth(binx);
+      _y=yaxis->GetBinLowEdge(biny)+random.Uniform()*yaxis->GetBinWidth(biny);
+    }
+
+    _val = GetValueForXY(_x,_y);
+    return dist_pair{_x,_y};
+  }
+  ///////////////////////////////////////////////////////////
+  double DistTH2::GetValueForXY(double valX,double valY) const noexcept{
+    const auto& tables=*_tables;
+    const auto& nodeX=tables._nodeX;
+    const auto& nodeY=tables._nodeY;
+    if(valX<nodeX.front() || valX>nodeX.back()) return 0;
+    if(valY<nodeY.front() || valY>nodeY.back()) return 0;
+
+    auto segment=[](const std::vector<double>& nodes,double val)->size_t{
+      size_t is=std::upper_bound(nodes.begin(),nodes.end(),val)-nodes.begin();
+      return std::min(is>0 ? is-1 : 0,nodes.size()-2);
+    };
+    auto ix=segment(nodeX,valX);
+    auto iy=segment(nodeY,valY);
+    auto tx=(valX-nodeX[ix])/(nodeX[ix+1]-nodeX[ix]);
+    auto ty=(valY-nodeY[iy])/(nodeY[iy+1]-nodeY[iy]);
+
+    const size_t nnodeX=nodeX.size();
+    auto i00=ix+iy*nnodeX;
+    const auto& q=tables._nodeVal;
+    return (1-tx)*(1-ty)*q[i00] + tx*(1-ty)*q[i00+1]
+      + (1-tx)*ty*q[i00+nnodeX] + tx*ty*q[i00+nnodeX+1];
   }
  
 }
@@ -1,14 +1,24 @@
 //////////////////////////////////////////////////////////////
 ///
-///Class:		DistTF1
+///Class:		DistTH2
 ///Description:
-///             wrapper for TH1 distributions
-/// 
-
+///             wrapper for TH2 distributions
+///             All cells are flattened into one alias table so a cell
+///             is sampled in constant time, then x,y are flat in the
+///             cell like TH2::GetRandom2, or with SetBilinearInCell()
+///             bilinear between cell centres (conditional CDFs), the
+///             same shape as GetValueForXY (TH2::Interpolate)
+///             Tables are built once and shared by copies, e.g.
+///             DistTH2 map(bigHist);  //preprocessed here
+///             auto dist = new DistTH2(map); //reuses tables
 #pragma once
 
 #include "Distribution.h"
+#include "ThreadRandom.h"
+#include "AliasTable.h"
 #include <TH2.h>
+#include <memory>
+#include <vector>
 
 namespace elSpectro{
 
@@ -23,18 +33,14 @@ namespace elSpectro{
       return 0;
     }
     
-    dist_pair SamplePair()   noexcept final {
-      _th2.GetRandom2(_x,_y);
-      _val = _th2.Interpolate(_x,_y);
-      return dist_pair{_x,_y};
-    } 
+    dist_pair SamplePair()   noexcept final;
 
     double CurrentValue() const noexcept final {return _val;}
     double MaxValue() const noexcept final {return _max_val;}
     double MinValue() const noexcept final {return _min_val;}
 
     double GetX() const noexcept { return _x;}
-    double GetY() const noexcept { return _x;}
+    double GetY() const noexcept { return _y;}
 
     //void SetX(double v) {_x=v;}
     //void SetY(double v) {_y=v;}
@@ -44,8 +50,13 @@ namespace elSpectro{
     double GetMinY() const noexcept final{return _th2.GetYaxis()->GetXmin();}
     double GetMaxY() const noexcept final{return _th2.GetYaxis()->GetXmax();}
 
-    double GetWeightForXY(double valX,double valY) const {return ((TH2D*)(&_th2))->Interpolate(valX,valY)/_max_val;}
-    double GetValueForXY(double valX,double valY) const {return ((TH2D*)(&_th2))->Interpolate(valX,valY);}
+    double GetWeightForXY(double valX,double valY) const {return GetValueForXY(valX,valY)/_max_val;}
+    //as TH2::Interpolate, bilinear between cell centres, 0 outside
+    double GetValueForXY(double valX,double valY) const noexcept;
+    double GetValueFor(double valX,double valY=0) final {return GetValueForXY(valX,valY);}
+
+    //sample bilinearly between cell centres rather than flat in cells
+    void SetBilinearInCell(bool bilinear=true);
     
     const TH2& GetTH2() const noexcept {return _th2;}
     
@@ -53,7 +64,19 @@ namespace elSpectro{
     //no one should use default constructor
     DistTH2()=default;
 
+    //nodes are the low edge, bin centres and high edge of each axis,
+    //end nodes take the values of the end bins
+    struct Tables{
+      std::vector<double> _nodeX;
+      std::vector<double> _nodeY;
+      std::vector<double> _nodeVal; //ix + iy*_nodeX.size()
+      AliasTable _cells; //cells or patches between nodes if bilinear
+      bool _bilinear={false};
+    };
+    void BuildTables(bool bilinear);
+
     TH2D _th2;
+    std::shared_ptr<const Tables> _tables;//!
     double _val{0};
     double _x{0};
     double _y{0};
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "Distribution.h"
-#include <TRandom.h>
+#include "ThreadRandom.h"
 
 namespace elSpectro{
 
@@ -22,12 +22,12 @@ namespace elSpectro{
     _xmin{xmin},_xmax{xmax},_ymin{xmin},_ymax{xmax},_val{val}{};
  
     double SampleSingle()  noexcept final {
-      return _x=gRandom->Uniform(_xmin,_xmax);
+      return _x=rng().Uniform(_xmin,_xmax);
     }
     
     dist_pair SamplePair()   noexcept final {
-      _x=gRandom->Uniform(_xmin,_xmax);
-      _y=gRandom->Uniform(_ymin,_ymax);
+      _x=rng().Uniform(_xmin,_xmax);
+      _y=rng().Uniform(_ymin,_ymax);
       return dist_pair{_x,_y};
     }
 
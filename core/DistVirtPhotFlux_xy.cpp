@@ -1,6 +1,8 @@
 #include "DistVirtPhotFlux_xy.h"
 
-#include <TRandom.h>
+#include "ThreadRandom.h"
+#include "Manager.h"
+#include "FunctionsForThreads.h"
 
 //For pdf integration
 #include <Math/Functor.h>
@@ -9,6 +11,9 @@
 #include <RooArgList.h>
 #include <utility>
 #include <functional>
+#include <algorithm>
+#include <array>
+#include <limits>
 
 namespace elSpectro{
 
@@ -68,17 +73,25 @@ namespace elSpectro{
 
     // FindMaxVal();
     
+    //results depend on beam, threshold and all requested limits
+    auto& cache=Manager::Instance().Cache();
+    InitCache::context_t context{_ebeam,_mTar,Wmin,_requestQ2min,_requestQ2max,
+	_requestThmin,_requestThmax,_requestXmin,_requestXmax,_requestYmin,_requestYmax};
+
     //Seacrh for lowest possible x...
-    _maxPossiblexRange=1;
     ymin = TMath::Exp(_lnymin);
     double ymax = TMath::Exp(_lnymax);
-    for(int i=0;i<1E5;i++){
-      //     double avail_xmin = XMin(static_cast<double>(i*(ymax-ymin) + ymin)/1E5);
-      //Need xmin with no experiment based limits on Q2 or theta
-      double yformin=static_cast<double>(i*(ymax-ymin) + ymin)/1E5;
-      double avail_xmin =escat::M2_el()*yformin/(2*_mTar*_ebeam)/(1-yformin);
-       if(avail_xmin<_maxPossiblexRange)
-	_maxPossiblexRange=avail_xmin;
+    if(cache.Get("DistVirtPhotFlux_xy::_maxPossiblexRange",context,_maxPossiblexRange)==false){
+      _maxPossiblexRange=1;
+      for(int i=0;i<1E5;i++){
+	//     double avail_xmin = XMin(static_cast<double>(i*(ymax-ymin) + ymin)/1E5);
+	//Need xmin with no experiment based limits on Q2 or theta
+	double yformin=static_cast<double>(i*(ymax-ymin) + ymin)/1E5;
+	double avail_xmin =escat::M2_el()*yformin/(2*_mTar*_ebeam)/(1-yformin);
+	if(avail_xmin<_maxPossiblexRange)
+	  _maxPossiblexRange=avail_xmin;
+      }
+      cache.Put("DistVirtPhotFlux_xy::_maxPossiblexRange",context,_maxPossiblexRange);
     }
      
     std::cout<<"DistVirtPhotFlux_xy::SetWThreshold new Wmin "<<GetWMin() <<" "<<TMath::Sqrt(2*_mTar*_ebeam*ymin+_mTar*_mTar)<<" "<<TMath::Sqrt(rmin + _mTar*_mTar)-_mTar*_mTar*ymin*ymin/(1-ymin)<<" "<<sqrt( _mTar*(_mTar + 2*ymin*_ebeam ) -  escat::Q2_xy( _ebeam,_maxPossiblexRange,ymin))<<" xmin "<<xmin<<" "<<XMin(ymin)<<" ymin "<<ymin<<std::endl;
@@ -102,27 +115,212 @@ namespace elSpectro{
     _lnxmax=0;
 
     //Finally, Integrate over photon flux
-    auto xvar = RooRealVar("x","x",-(_lnxmax-_lnxmin)/2,_lnxmin,_lnxmax,"");
-    auto yvar = RooRealVar("y","y",-(_lnymax-_lnymin)/2,_lnymin,_lnymax,"");
-    xvar.Print();
-    yvar.Print();
+    if(cache.Get("DistVirtPhotFlux_xy::_integral",context,_integral)==false){
+      auto xvar = RooRealVar("x","x",-(_lnxmax-_lnxmin)/2,_lnxmin,_lnxmax,"");
+      auto yvar = RooRealVar("y","y",-(_lnymax-_lnymin)/2,_lnymin,_lnymax,"");
+      xvar.Print();
+      yvar.Print();
     
-    auto flambda = [this](const double *x)
-      {
-	if(x[0]==0) return 0.;
-	if(x[1]==0) return 0.;
-	auto val = Eval(x);
-	return val;
-      };
+      auto flambda = [this](const double *x)
+	{
+	  if(x[0]==0) return 0.;
+	  if(x[1]==0) return 0.;
+	  auto val = Eval(x);
+	  return val;
+	};
 
     
-    auto wrapPdf=ROOT::Math::Functor( flambda , 2);
-    auto pdf = RooFunctorPdfBinding("PdfDistVirtPhotFlux_xy", "PdfDistVirtPhotFlux_xy", wrapPdf, RooArgList(xvar,yvar));
-    auto roovars= RooArgSet(xvar,yvar);
+      auto wrapPdf=ROOT::Math::Functor( flambda , 2);
+      auto pdf = RooFunctorPdfBinding("PdfDistVirtPhotFlux_xy", "PdfDistVirtPhotFlux_xy", wrapPdf, RooArgList(xvar,yvar));
+      auto roovars= RooArgSet(xvar,yvar);
  
-    _integral=pdf.getNorm(roovars);
+      _integral=pdf.getNorm(roovars);
+      cache.Put("DistVirtPhotFlux_xy::_integral",context,_integral);
+    }
+
+    std::cout<<"DistVirtPhotFlux_xy INTEGRAL "<<_integral<<" at proton rest frame e- energy "<<_ebeam<<" and W threshold "<<TMath::Sqrt(_Wthresh2)<< std::endl;
+
+    BuildEnvelope();
+  }
+  ////////////////////////////////////////////////////////////////////
+  ///Start from a regular grid and split cells in 4 where the flux
+  ///changes by more than 10% or the x,y limits cut through them
+  void DistVirtPhotFlux_xy::BuildEnvelope(){
+    constexpr int NRoot=16;
+
+    const double amin= _xWithinLimits ? 0 : _lnxmin;
+    const double amax= _xWithinLimits ? 1 : _lnxmax;
+    const double da=(amax-amin)/NRoot;
+    const double dlny=(_lnymax-_lnymin)/NRoot;
+    std::vector<std::vector<EnvelopeCell>> rootLeaves(NRoot*NRoot);
+    threads::parallelFor(NRoot*NRoot,[&](int ic){
+	EnvelopeCell root;
+	root._lnx0=amin+(ic%NRoot)*da;
+	root._lnx1=root._lnx0+da;
+	root._lny0=_lnymin+(ic/NRoot)*dlny;
+	root._lny1=root._lny0+dlny;
+	SplitCell(root,0,rootLeaves[ic]);
+      });
+
+    _cells.clear();
+    for(const auto& leaves:rootLeaves)
+      _cells.insert(_cells.end(),leaves.begin(),leaves.end());
+    if(_cells.empty()){
+      std::cerr<<"DistVirtPhotFlux_xy::BuildEnvelope no x,y values within limits, exiting..."<<std::endl;
+      exit(0);
+    }
+
+    BuildCellTable();
 
-    std::cout<<"DistVirtPhotFlux_xy INTEGRAL "<<pdf.getNorm(roovars)<<" at proton rest frame e- energy "<<_ebeam<<" and W threshold "<<TMath::Sqrt(_Wthresh2)<< std::endl;
+    std::cout<<"DistVirtPhotFlux_xy::BuildEnvelope "<<_cells.size()<<" cells, expected efficiency "<<EnvelopeEfficiency()<<std::endl;
+  }
+  ////////////////////////////////////////////////////////////////////
+  ///cells are picked with probability max*area
+  void DistVirtPhotFlux_xy::BuildCellTable(){
+    std::vector<double> weights(_cells.size());
+    _max_val=0;
+    for(size_t ic=0;ic<_cells.size();++ic){
+      auto& cell=_cells[ic];
+      cell._tableMax=cell._max;
+      weights[ic]=cell._max*(cell._lnx1-cell._lnx0)*(cell._lny1-cell._lny0);
+      _max_val=std::max(_max_val,cell._max);
+    }
+    _cellTable.Build(weights);
+    _tableStale=false;
+  }
+  ////////////////////////////////////////////////////////////////////
+  ///Raise the cell above the current value, the table is rebuilt
+  ///with all raised cells at the start of the next event
+  void DistVirtPhotFlux_xy::RaiseCell(EnvelopeCell& cell,double lnx,double lny){
+    if(_nRaised++<10)
+      std::cout<<"DistVirtPhotFlux_xy::FindWithAcceptReject() envelope cell exceeded, raising from "<<cell._max<<" to "<<_val*1.05<<" lnx "<<lnx<<" lny "<<lny<<std::endl;
+    if(_val<=cell._max) return;
+    cell._max=_val*1.05;
+    _tableStale=true;
+  }
+  ////////////////////////////////////////////////////////////////////
+  ///Outside of the limits the flux is continued so the maximum
+  ///found on a cell sub grid is still an upper bound inside
+  double DistVirtPhotFlux_xy::EnvelopeValue(double a,double lny,double& lnx,bool& inside) const{
+    double y=TMath::Exp(lny);
+    double avail_xmin=XMin(y);
+    double avail_xmax=XMax(y);
+    if(_xWithinLimits==false){
+      lnx=a;
+      auto currx=TMath::Exp(lnx);
+      inside = lny>=_lnymin && lny<=_lnymax && currx>=avail_xmin && currx<=avail_xmax;
+      return escat::flux_dlnxdlny(_ebeam,lnx,lny);
+    }
+
+    //ln x range at this y, flux*range -> 0 as the range closes
+    double lnxlow= avail_xmin>_maxPossiblexRange ? TMath::Log(avail_xmin) : _lnxmin;
+    double lnxhigh= avail_xmax>0 ? TMath::Log(avail_xmax) : lnxlow;
+    inside = lny>=_lnymin && lny<=_lnymax && lnxhigh>lnxlow;
+    if(inside==false){
+      lnx=lnxlow;
+      return 0;
+    }
+    lnx=lnxlow+a*(lnxhigh-lnxlow);
+    return escat::flux_dlnxdlny(_ebeam,lnx,lny)*(lnxhigh-lnxlow);
+  }
+  ////////////////////////////////////////////////////////////////////
+  ///cell max = largest flux on a sub grid + largest change between
+  ///neighbouring sub grid points, as the flux may peak between them
+  void DistVirtPhotFlux_xy::SplitCell(const EnvelopeCell& cell,int depth,std::vector<EnvelopeCell>& leaves) const{
+    constexpr int NSub=4;
+    constexpr int MaxDepth=4;
+
+    if(_xWithinLimits){
+      //cell covers a fraction of every ln x range in its y range
+      auto full=cell;
+      full._lnx0=_lnxmin;
+      full._lnx1=_lnxmax;
+      if(CellInsideLimits(full)==false) return;
+    }
+    else if(CellInsideLimits(cell)==false) return;
+
+    const double da=(cell._lnx1-cell._lnx0)/NSub;
+    const double dlny=(cell._lny1-cell._lny0)/NSub;
+    std::array<double,(NSub+1)*(NSub+1)> vals;
+    double vmax=0;
+    double vmin=std::numeric_limits<double>::max();
+    double slack=0;
+    int ninside=0;
+    for(int iy=0;iy<=NSub;++iy){
+      double lny=cell._lny0+iy*dlny;
+      for(int ia=0;ia<=NSub;++ia){
+	double lnx=0;
+	bool inside=false;
+	auto& val=vals[iy*(NSub+1)+ia];
+	val=EnvelopeValue(cell._lnx0+ia*da,lny,lnx,inside);
+	vmax=std::max(vmax,val);
+	vmin=std::min(vmin,val);
+	if(ia>0) slack=std::max(slack,std::abs(val-vals[iy*(NSub+1)+ia-1]));
+	if(iy>0) slack=std::max(slack,std::abs(val-vals[(iy-1)*(NSub+1)+ia]));
+	if(inside) ++ninside;
+      }
+    }
+
+    bool partial = ninside < (NSub+1)*(NSub+1);
+    if(depth<MaxDepth && (partial || vmax-vmin > 0.1*vmax)){
+      const double midx=(cell._lnx0+cell._lnx1)/2;
+      const double midy=(cell._lny0+cell._lny1)/2;
+      SplitCell({cell._lnx0,midx,cell._lny0,midy,0},depth+1,leaves);
+      SplitCell({midx,cell._lnx1,cell._lny0,midy,0},depth+1,leaves);
+      SplitCell({cell._lnx0,midx,midy,cell._lny1,0},depth+1,leaves);
+      SplitCell({midx,cell._lnx1,midy,cell._lny1,0},depth+1,leaves);
+      return;
+    }
+
+    auto leaf=cell;
+    leaf._max=(vmax+slack)*1.02;
+    if(leaf._max>0) leaves.push_back(leaf);
+  }
+  ////////////////////////////////////////////////////////////////////
+  ///false only if the allowed x range misses the cell at every y
+  ///checked. Between two checks the x range may move quickly with y
+  ///so the range spanned by both is used. The limits change fastest
+  ///as y->1 so checks are spread in ln(1-y) as well as ln(y)
+  bool DistVirtPhotFlux_xy::CellInsideLimits(const EnvelopeCell& cell) const{
+    constexpr int NCheck=16;
+
+    //no scattered electron above this
+    const double ymax=std::min(TMath::Exp(cell._lny1),1-escat::M_el()/_ebeam);
+    const double ymin=TMath::Exp(cell._lny0);
+    if(ymin>=ymax) return false;
+
+    std::vector<double> ychecks;
+    ychecks.reserve(2*NCheck+2);
+    const double ln1mymin=TMath::Log(1-ymin);
+    const double ln1mymax=TMath::Log(1-ymax);
+    for(int ic=0;ic<=NCheck;++ic){
+      ychecks.push_back(std::min(TMath::Exp(cell._lny0+ic*(cell._lny1-cell._lny0)/NCheck),ymax));
+      ychecks.push_back(1-TMath::Exp(ln1mymin+ic*(ln1mymax-ln1mymin)/NCheck));
+    }
+    std::sort(ychecks.begin(),ychecks.end());
+
+    double prevlo=0;
+    double prevhi=0;
+    bool prevValid=false;
+    for(auto y:ychecks){
+      double avail_xmin=XMin(y);
+      double avail_xmax=XMax(y);
+      if( !(avail_xmax>0 && avail_xmin<avail_xmax) ){
+	prevValid=false;
+	continue;
+      }
+      double lo=TMath::Log(avail_xmin);
+      double hi=TMath::Log(avail_xmax);
+      if(prevValid){
+	lo=std::min(lo,prevlo);
+	hi=std::max(hi,prevhi);
+      }
+      if(lo<=cell._lnx1 && hi>=cell._lnx0) return true;
+      prevlo=TMath::Log(avail_xmin);
+      prevhi=TMath::Log(avail_xmax);
+      prevValid=true;
+    }
+    return false;
   }
 
   void DistVirtPhotFlux_xy::FindMaxVal(){
@@ -131,58 +329,54 @@ namespace elSpectro{
     
     for(int i=0;i<1E7;i++){
       //note r=Q2/A2 when W=Mtar so xmin==1, so just scan from low x instead
-      double ranX=gRandom->Uniform(TMath::Log(_maxPossiblexRange),TMath::Log(1));
-      double ranY=gRandom->Uniform(_lnymin,_lnymax);
+      double ranX=rng().Uniform(TMath::Log(_maxPossiblexRange),TMath::Log(1));
+      double ranY=rng().Uniform(_lnymin,_lnymax);
       double val  = escat::flux_dlnxdlny(_ebeam,ranX,ranY);
       //double val  = escat::flux_dlnxdlny(_ebeam,ranX,ranY)*WeightForW(TMath::Exp(ranX),TMath::Exp(ranY));
       if(val>_max_val){_max_val=val;}
     }
     _max_val*=1.02; //to be sure got max
    }
- 
+  ////////////////////////////////////////////////////////////////////
+  ///Pick an envelope cell with probability its max*area, throw a
+  ///uniform point in it and accept with probability flux/max
+  ///or for weighted events keep it with weight flux/max
+  ///The cell max is an estimate, if the flux exceeds it the cell is
+  ///raised for later events. The point is kept with weight flux/max
+  ///if events are weighted anyway, else it is drawn again so plain
+  ///accept/reject is exact once the table is rebuilt
   void DistVirtPhotFlux_xy::FindWithAcceptReject(){
+    if(_tableStale) BuildCellTable();
     
-    double lny=0;
     double lnx=0;
-    
-    auto getRandomXY = [&lny,&lnx,this](){
-      
-      lny = gRandom->Uniform(_lnymin,_lnymax);
-      double y = TMath::Exp(lny);
-
-      //calculate the fraction of x-space available
-      //now calculate x limits
-      //y = r/2ME and x = Q2/r 
-      double avail_xmax = XMax(y);
-      double avail_xmin = XMin(y);
-  
-      if(avail_xmin>=1){ lnx=1;return; }
-
-      if(_maxPossiblexRange)
-	//for efficiency we need not sample below lowest possible x value
-	lnx = gRandom->Uniform(TMath::Log(_maxPossiblexRange),TMath::Log(1));
-      else 
- 	lnx = gRandom->Uniform(TMath::Log(1E-50),TMath::Log(1));
-  
-      //check if we are within allowed x-range
-      //if not return and throw another y value
-      auto currx=TMath::Exp(lnx);
-      if(currx>avail_xmax){ lnx=1;return; }
-      if(currx<avail_xmin){ lnx=1;return; }
-    };
-
-    getRandomXY();//intial sample
+    double lny=0;
+    auto& random=rng(); //engine for this thread
+    const bool weighted=Manager::Instance().WeightedEvents();
+    const bool keepExceeded=weighted || Manager::Instance().AdaptiveEnvelopes();
+    _weight=1;
 
-    while(  gRandom->Uniform()*_max_val >
-	    (_val=escat::flux_dlnxdlny(_ebeam,lnx,lny)) ) {
-      if(_val>_max_val){
-	_max_val=_val;
-	std::cout<<"DistVirtPhotFlux_xy::FindWithAcceptReject() MAX REACHED "<<_val<<" "<<_max_val<<std::endl;
-	exit(0);
+    while(true){
+      auto icell=_cellTable.Sample(random);
+      auto& cell=_cells[icell];
+      double a=random.Uniform(cell._lnx0,cell._lnx1);
+      lny=random.Uniform(cell._lny0,cell._lny1);
+      bool inside=false;
+      _val=EnvelopeValue(a,lny,lnx,inside);
+      if(inside==false) continue;
+      //the table picked the cell with _tableMax
+      if(_val>cell._tableMax){
+	RaiseCell(cell,lnx,lny);
+	if(keepExceeded==false) continue;
+	_weight=_val/cell._tableMax;
+	break;
       }
-      getRandomXY(); //sample another pair
+      if(weighted){
+	if(_val<=0) continue;
+	_weight=_val/cell._tableMax;
+	break;
+      }
+      if(random.Uniform()*cell._tableMax <= _val && _val>0) break;
     }
-    
 
     //now we want the value of ths function to be Photon flux as function of x and y
     auto x=TMath::Exp(lnx);
@@ -204,7 +398,7 @@ namespace elSpectro{
     
     auto getRandomXY = [&lny,&lnx,this](){
       
-      lny = gRandom->Uniform(_lnymin,_lnymax);
+      lny = rng().Uniform(_lnymin,_lnymax);
       double y = TMath::Exp(lny);
 
       //calculate the fraction of x-space available
@@ -217,9 +411,9 @@ namespace elSpectro{
 
       if(_maxPossiblexRange)
 	//for efficiency we need not sample below lowest possible x value
-	lnx = gRandom->Uniform(TMath::Log(_maxPossiblexRange),TMath::Log(1));
+	lnx = rng().Uniform(TMath::Log(_maxPossiblexRange),TMath::Log(1));
       else 
- 	lnx = gRandom->Uniform(TMath::Log(1E-50),TMath::Log(1));
+ 	lnx = rng().Uniform(TMath::Log(1E-50),TMath::Log(1));
   
       //check if we are within allowed x-range
       //if not return and throw another y value
@@ -232,11 +426,11 @@ namespace elSpectro{
 
     auto x=TMath::Exp(lnx);
     auto y=TMath::Exp(lny);
-    while(  gRandom->Uniform()*_max_val >
+    while(  rng().Uniform()*_max_val >
     	    (_val=escat::flux_dlnxdlny(_ebeam,lnx,lny)*WeightForW(x,y) )) {
-      //while(  gRandom->Uniform()*_max_val >
+      //while(  rng().Uniform()*_max_val >
       //    (_val=escat::flux_dlnxdlny(_ebeam,lnx,lny)) ) {
-       //if(gRandom->Uniform()>WeightForW(x,y))
+       //if(rng().Uniform()>WeightForW(x,y))
        // continue;
        
       if(_val>_max_val){
@@ -4,11 +4,27 @@
 ///Description:
 ///             Virtual photon flux distribution as a function of x and y
 ///             Uses accept or reject from log(x,y) flux function
+///             The envelope is piecewise constant on an adaptive grid
+///             of (lnx,lny) cells, refined where the flux changes or
+///             the cuts pass through. Cells outside the cuts are
+///             dropped, a cell is picked from an alias table and a
+///             point thrown uniformly inside it
+///             With SetSampleWithinXLimits(true) the envelope is in
+///             (u,lny) with lnx = lnXMin(y) + u*(lnXMax(y)-lnXMin(y))
+///             so samples are always inside tight Q2 or theta limits,
+///             the flux is then multiplied by the ln x range (Jacobian)
+///             With Manager::SetWeightedEvents() every point inside
+///             the limits is kept and Weight() gives flux/cell max
+///             A point above its cell max raises the cell, the alias
+///             table is rebuilt once before the next event. Weighted
+///             events or adaptive envelopes keep the point with
+///             Weight() > 1, plain accept/reject draws again
 
 #pragma once
 
 #include "Distribution.h"
 #include "DistTH1.h"
+#include "AliasTable.h"
 #include "FunctionsForElectronScattering.h"
 #include <TMath.h>
 #include <RooRealVar.h>
@@ -32,6 +48,8 @@ namespace elSpectro{
     }
 
     double CurrentValue() const noexcept final {return _val;}
+    //weight of the last sample, 1 unless weighted events
+    double Weight() const noexcept {return _weight;}
     double MaxValue() const noexcept final {return _max_val;}
     double MinValue() const noexcept final {return 0;}
 
@@ -62,6 +80,9 @@ namespace elSpectro{
 
     void SetYmax(double val){_requestYmax=val;}
     void SetYmin(double val){_requestYmin=val;}
+    //sample ln x only within the limits for each y, faster for
+    //narrow Q2 or theta ranges, same distribution
+    void SetSampleWithinXLimits(bool within=true){_xWithinLimits=within;}
 
 
     void ForIntegrate(bool integ){_forIntegral=integ;}
@@ -77,6 +98,15 @@ namespace elSpectro{
     }
  
     void FindMaxVal();
+    //called by SetWThreshold, needed again after changing limits
+    void BuildEnvelope();
+    size_t NEnvelopeCells() const noexcept{return _cells.size();}
+    //times a cell max was exceeded while generating
+    long NEnvelopeRaised() const noexcept{return _nRaised;}
+    //expected fraction of envelope samples accepted
+    double EnvelopeEfficiency() const noexcept{
+      return _cellTable.Empty() ? 0 : _integral/_cellTable.Sum();
+    }
 
     /*
 //tested but not used, apply W weighting from cross section
@@ -103,9 +133,28 @@ namespace elSpectro{
   private:
     //no one should use default constructor
     DistVirtPhotFlux_xy()=default;
+
+    //_lnx0,_lnx1 are u when sampling within x limits
+    struct EnvelopeCell{
+      double _lnx0={0};
+      double _lnx1={0};
+      double _lny0={0};
+      double _lny1={0};
+      double _max={0};  //>= flux anywhere in cell
+      double _tableMax={0}; //_max when the alias table was built
+    };
+    //cell coordinate a is lnx or the fraction u of the ln x range,
+    //gives lnx and the value the envelope must bound,
+    //inside=false if (lnx,lny) is outside of the limits
+    double EnvelopeValue(double a,double lny,double& lnx,bool& inside) const;
+    void SplitCell(const EnvelopeCell& cell,int depth,std::vector<EnvelopeCell>& leaves) const;
+    bool CellInsideLimits(const EnvelopeCell& cell) const;
+    void BuildCellTable();
+    void RaiseCell(EnvelopeCell& cell,double lnx,double lny);
     
     dist_pair _xy{0,0};
     double _val{0};
+    double _weight{1};
 
     //limits
     double _ebeam={0};
@@ -133,6 +182,12 @@ namespace elSpectro{
     double _integral=1;
 
     bool _forIntegral=false;
+    bool _xWithinLimits=false;
+
+    std::vector<EnvelopeCell> _cells;//!
+    AliasTable _cellTable;//!
+    long _nRaised={0};//!
+    bool _tableStale={false};//! cells raised since BuildCellTable
 
     //  std::unique_ptr<DistTH1> _approxWDist;
     
@@ -1,28 +1,27 @@
 #include "EICSimpleWriter.h"
 #include <TDatabasePDG.h>
 #include <iostream>
+#include <fstream>
 
 namespace elSpectro{
 
   ///Constructor to create ouput file and intialise data structures
   EICSimpleWriter::EICSimpleWriter(const std::string &filename,long evPerFile):
-    _filename(filename),
-    _file(filename),
+    Writer{filename},
     _eventsPerFile(evPerFile)
   {
-    if(!_file.is_open()){
-      std::cerr<<"EICSimpleWriter::EICSimpleWriter file "<<filename<<" cannot be opened, exiting..."<<std::endl;
-      exit(0);
-    }
+    WriteHeader();
+    Write();
+
+  }
+  ///////////////////////////////////////////////////////////////
+  void EICSimpleWriter::WriteHeader(){
     _stream << "SIMPLE Event FILE"  << std::endl;
     _stream << "============================================" << std::endl;
     _stream << "    I, ievent, nParticles"  << std::endl;
     _stream << "============================================"  << std::endl;
     _stream << "I  K(I,1)  K(I,2)  K(I,3)  K(I,4)  K(I,5)  P(I,1)  P(I,2)  P(I,3)  P(I,4)  P(I,5)  V(I,1)  V(I,2)  V(I,3)"  << std::endl;
     _stream << "============================================"  << std::endl;
-    
-    Write();
-
   }
   
   EICSimpleWriter::~EICSimpleWriter(){
@@ -34,19 +33,21 @@ namespace elSpectro{
 
     Writer::Init();
     //need to find e- and baryon
+    //initial particles come first in EventRecord
     if(TDatabasePDG::Instance()->GetParticle(_initialParticles[0]->Pdg())->ParticleClass()==TString("Baryon") ){
-      _inTarget=_initialParticles[0];
-      _inBeam=_initialParticles[1]; 
+      _targetIndex=0;
+      _beamIndex=1; 
     }
     else {
-      _inTarget=_initialParticles[1];
-      _inBeam=_initialParticles[0];
+      _targetIndex=1;
+      _beamIndex=0;
     }
  
-    _beamPdg=_inBeam->Pdg();
-    _targetPdg=_inTarget->Pdg();
+    _beamPdg=_initialParticles[_beamIndex]->Pdg();
+    _targetPdg=_initialParticles[_targetIndex]->Pdg();
 
-    _photon.SetVertex(_inBeam->VertexID(),_inBeam->VertexPosition());
+    _photon._pdg=22;
+    _photon._vertex=_initialParticles[_beamIndex]->VertexID();
  
   }
   ///////////////////////////////////////////////////////////////
@@ -57,6 +58,28 @@ namespace elSpectro{
 
   }
   ///////////////////////////////////////////////////////////////
+  ///Keep file header from first shard only
+  void EICSimpleWriter::MergeShards(const std::vector<std::string>& shards,
+				    const std::string& merged) const{
+    std::ofstream out(merged);
+    if(!out.is_open()){
+      std::cerr<<"EICSimpleWriter::MergeShards file "<<merged<<" cannot be opened, exiting..."<<std::endl;
+      exit(0);
+    }
+    const int nHeaderLines=6;//as written in constructor
+    bool first=true;
+    std::string line;
+    for(const auto& shard:shards){
+      std::ifstream in(shard);
+      int iline=0;
+      while(std::getline(in,line)){
+	if( (iline++ < nHeaderLines) && first==false ) continue;
+	out<<line<<"\n";
+      }
+      first=false;
+    }
+  }
+  ///////////////////////////////////////////////////////////////
   ///Reached max events for this file start another
   void EICSimpleWriter::NewFile(){
     End();
@@ -67,24 +90,24 @@ namespace elSpectro{
 
   /////////////////////////////////////////////////////////////
   //write all the info required for this event
-  void EICSimpleWriter::FillAnEvent(){
+  void EICSimpleWriter::FillAnEvent(const EventRecord& event){
      
     ////fill _stream
-    StreamEventInfo();
+    StreamEventInfo(event);
  
     _id=1;//reset particle ID counter
  
     //initial particles
     int initial_status=21;
-    StreamParticle(_inBeam,initial_status);
-    StreamParticle(_inTarget,initial_status);
-    StreamParticle(&_photon,initial_status);
+    StreamParticle(event,event.Particles()[_beamIndex],initial_status);
+    StreamParticle(event,event.Particles()[_targetIndex],initial_status);
+    StreamParticle(event,_photon,initial_status);
    
     //final particles
     int final_status=1;
-    for(const auto* p:_finalParticles){
-     
-      StreamParticle(p,final_status);
+    for(const auto& p:event.Particles()){
+      if(p._status!=RecordStatus::Final) continue;
+      StreamParticle(event,p,final_status);
   
      }
     _stream << "=============== Event finished ===============\n";
@@ -97,13 +120,6 @@ namespace elSpectro{
 
   /////////////////////////////////////////////////////////
  
-  /////////////////////////////////////////////////////////
-  void EICSimpleWriter::Write(){
-    //write stream
-    _file<<_stream.rdbuf();
-    //reset stream
-    _stream.clear();
-  }
 
  
 }
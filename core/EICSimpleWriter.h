@@ -30,45 +30,44 @@ namespace elSpectro{
      EICSimpleWriter& operator=(const EICSimpleWriter& other);
      EICSimpleWriter& operator=(EICSimpleWriter&& other) = default;
      
-     void WriteHeader() final{};
-     void FillAnEvent() final;
-     void Write() final;
+     void WriteHeader() final;
+     using Writer::FillAnEvent;
+     void FillAnEvent(const EventRecord& event) final;
      void End() final;
      void Init() final;
      void NewFile();
      
+     void MergeShards(const std::vector<std::string>& shards,
+		      const std::string& merged) const final;
+     
    private:
      //streaming functions
      
-     void StreamEventInfo(){
+     void StreamEventInfo(const EventRecord& event){
        // Header (Event Info):
        // # of Particles, # of Target Nucleons, # of Target Protons,
        // Pol. of Target, Pol. of Electron,
        // BeamType, BeamEnergy,Target ID, ProcessID, Weight
   
-       _stream<<"0"<< "\t"<<_nEvent<< "\t"<<_finalParticles.size()<<"\n";
+       _stream<<"0"<< "\t"<<_nEvent<< "\t"<<event.NParticles(RecordStatus::Final)<<"\n";
        _stream << "============================================\n";
     }
-     void StreamParticle(const Particle* p,int status){
-       auto p4=p->P4();
-       auto ver=p->VertexPosition();
+     void StreamParticle(const EventRecord& event,const RecordParticle& p,int status){
+       const auto& p4=p._p4;
+       const auto& ver=event.Vertices()[p._vertex];
        //second entry 0. == lifetime Could add to Particle.h
        //note assume cm
        int parent=0;
        int daughter_first=0;
        int daughter_last=0;
        _stream<<_id++<<"\t"<<status
-	      <<"\t"<<p->Pdg()<<"\t"<<parent<<"\t"
+	      <<"\t"<<p._pdg<<"\t"<<parent<<"\t"
 	      <<daughter_first<<"\t"<<daughter_last<<"\t"
 	      <<p4.X()<<"\t"<<p4.Y()<<"\t"<<p4.Z()<<"\t"<<p4.T()<<"\t"
-	      <<p4.M()<<"\t"<<ver->X()<<"\t"<<ver->Y()<<"\t"<<ver->Z()<<"\n";
+	      <<p4.M()<<"\t"<<ver.X()<<"\t"<<ver.Y()<<"\t"<<ver.Z()<<"\n";
      }
    
      //data members
-     std::ofstream _file; //! output file
-     //std::ostream _stream; //! output stream
-     std::stringstream _stream;
-     std::string _filename;
      
      long _nEvent={0};
      int _nFile={1};
@@ -78,9 +77,9 @@ namespace elSpectro{
      int _beamPdg=0;
      int _targetPdg=0;
      
-     const Particle* _inBeam={nullptr};
-     const Particle* _inTarget={nullptr};
-    Particle _photon={22}; //virtual photon pdg=22
+     size_t _beamIndex={0}; //in EventRecord::Particles()
+     size_t _targetIndex={1};
+     RecordParticle _photon; //virtual photon pdg=22
     
      ClassDef(elSpectro::EICSimpleWriter,1); //class Writer
    };
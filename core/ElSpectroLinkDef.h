@@ -44,6 +44,10 @@
 #pragma link C++ class elSpectro::DistConst+;
 #pragma link C++ class elSpectro::DistUniform+;
 #pragma link C++ class elSpectro::DistTF1+;
+#pragma link C++ class elSpectro::DistBreitWigner+;
+#pragma link C++ class elSpectro::DistRelBreitWigner+;
+#pragma link C++ class elSpectro::DistExponential+;
+#pragma link C++ class elSpectro::DistGaussian+;
 #pragma link C++ class elSpectro::DistTH1+;
 #pragma link C++ class elSpectro::DistTH2+;
 #pragma link C++ class elSpectro::DistFlatMass+;
@@ -55,12 +59,35 @@
 #pragma link C++ class elSpectro::GlueXWriter+;
 #pragma link C++ class elSpectro::EICSimpleWriter+;
 #pragma link C++ class elSpectro::HepMC3Writer+;
+#pragma link C++ class elSpectro::AsyncWriter+;
+#pragma link C++ class elSpectro::UnweightingWriter+;
+#pragma link C++ class elSpectro::EventRecord+;
+#pragma link C++ class elSpectro::RecordParticle+;
+#pragma link C++ class elSpectro::ReactionKinematics+;
+#pragma link C++ class elSpectro::EventBlock+;
+#pragma link C++ class elSpectro::VegasIntegrator+;
+#pragma link C++ class elSpectro::FoamSampler+;
+#pragma link C++ class elSpectro::InterpolationGrid+;
+#pragma link C++ class elSpectro::InitCache+;
+#pragma link C++ class elSpectro::AliasTable+;
+#pragma link C++ class elSpectro::EnvelopeAdaptor+;
+#pragma link C++ class elSpectro::InverseCDFTable+;
 
 
 #pragma link C++ class elSpectro::ParticleManager+;
 #pragma link C++ class elSpectro::DecayManager+;
 #pragma link C++ class elSpectro::MassPhaseSpace+;
 #pragma link C++ class elSpectro::Manager+;
+#pragma link C++ class elSpectro::RunStatistics+;
+#pragma link C++ class elSpectro::GeneratorContext+;
+#pragma link C++ class elSpectro::ParallelGenerator+;
+#pragma link C++ class elSpectro::RandomEngine+;
+#pragma link C++ class elSpectro::PhiloxEngine+;
+#pragma link C++ class elSpectro::TRandomEngine+;
+#pragma link C++ function elSpectro::rng;
+#pragma link C++ function elSpectro::threadRandom;
+#pragma link C++ function elSpectro::setThreadRandomEngine;
+#pragma link C++ function elSpectro::setDefaultRandomEngine;
 
 #pragma link C++ defined_in "Interface.h";
 #pragma link C++ defined_in "FunctionsForElectronScattering.h";
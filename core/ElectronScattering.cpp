@@ -3,18 +3,15 @@
 #include "Manager.h"
 #include "Interface.h" //for generator
 #include "ScatteredElectron_xy.h"
+#include "TwoBodyFlat.h"
 #include <TDatabasePDG.h>
 #include <TH1F.h>
 #include <TFile.h>
 #include <TBenchmark.h>
+#include <algorithm>
 
-#include <Math/Functor.h>
-#include <RooFunctorBinding.h>
-#include <RooRealVar.h>
-#include <RooArgList.h>
 
 namespace elSpectro{
-  int ElectronScattering::NintegralsElectronScattering=0;
 
   /////////////////////////////////////////////////////////////////////
   ElectronScattering::ElectronScattering(double ep,double ionp, DecayModel* model, int ionpdg):
@@ -136,6 +133,13 @@ namespace elSpectro{
 
    }
   /////////////////////////////////////////////////////////////////////////
+  void ElectronScattering::Print() const{
+    ProductionProcess::Print();
+    auto photonFlux= dynamic_cast<const ScatteredElectron_xy* >(Decayer());
+    if(photonFlux!=nullptr && photonFlux->Dist().NEnvelopeRaised()>0)
+      std::cout<<"\t photon flux envelope cells exceeded "<<photonFlux->Dist().NEnvelopeRaised()<<" times"<<std::endl;
+  }
+  /////////////////////////////////////////////////////////////////////////
   void ElectronScattering::InitGen(){
     std::cout<<"Electron Scattering InitGen "<<std::endl;
     //pass on lorentzvectors in nucleon rest frame
@@ -185,6 +189,9 @@ namespace elSpectro{
       if(_Ymax!=0)  decayer->Dist().SetYmax(_Ymax);
       if(_eThmin!=0)  decayer->Dist().SetThmin(_eThmin);
       if(_eThmax!=0)  decayer->Dist().SetThmax(_eThmax);
+      //sample x within these limits rather than rejecting outside them
+      if(_Q2min!=0||_Q2max!=0||_Xmin!=0||_Xmax!=0||_eThmin!=0||_eThmax!=0)
+	decayer->Dist().SetSampleWithinXLimits();
 
       //Do momemntum =>y, W limits last
       _Wmin=  minMass;
@@ -252,6 +259,8 @@ namespace elSpectro{
 
     
     ProductionProcess::PostInit(dynamic_cast<ReactionInfo*>(&_reactionInfo));
+
+    if(_foamCells>0) InitFoam();
  
    }
   //////////////////////////////////////////////////////////////////////////
@@ -287,6 +296,101 @@ namespace elSpectro{
   }
 
  
+  //////////////////////////////////////////////////////////////////////////
+  ///Integrand of IntegrateCrossSection, also drives the foam
+  ///W, Q2 and the photon polarisation are calculated here from x and y
+  ///as ScatteredElectron_xy and DecayModelQ2W would, without moving
+  ///the particles, so it may be called from many threads if the g*N
+  ///model can be evaluated concurrently
+  std::function<double(const double*)> ElectronScattering::CrossSectionIntegrand(){
+    auto photonFlux= dynamic_cast<ScatteredElectron_xy* >(mutableDecayer());
+    auto gStarModel =dynamic_cast<DecayModelst*>(_gStarN->Model());
+    auto Q2WModel =dynamic_cast<DecayModelQ2W*>(Model());
+    //e+N in the electron beam frame of ScatteredElectron_xy::CompleteGivenXandY
+    const auto parentP=P4().P();
+    const auto parentE=P4().E();
+
+    return [photonFlux,gStarModel,Q2WModel,parentP,parentE](const double *x)
+      {
+	if(x[0]==0) return 0.; //x
+	if(x[1]==0) return 0.; //y
+	auto val = photonFlux->Dist().Eval(x);
+	if(TMath::IsNaN(val)) return 0.;
+	if(val==0) return 0.;
+	//scattered electron at x and y
+	auto xx=TMath::Exp(x[0]);
+	auto yy=TMath::Exp(x[1]);
+	auto Ee=escat::E_el(parentP);
+	auto Esc=Ee*(1-yy);
+	auto costh=std::min(escat::CosTh_xy(Ee,xx,yy),1.);
+	auto Psc=escat::P_el(Esc);
+	//virtual photon
+	auto Q2=escat::Q2_xy(Ee,xx,yy);
+	auto gStarE=parentE-Esc;
+	auto gStarPz=parentP-Psc*costh;
+	auto gStarPt2=Psc*Psc*(1-costh*costh);
+	auto W=TMath::Sqrt(gStarE*gStarE-gStarPz*gStarPz-gStarPt2);
+	if(TMath::IsNaN(W)) return 0.;
+	auto epsilon=2*(1-yy)/(1+(1-yy)*(1-yy));
+	auto delta=2*escat::M2_el()/Q2*(1-epsilon);
+	//get value of dsigma(s)/dcosth cross section at x,y,costh
+	Double_t dsigma_costh=gStarModel->dsigma_costhWQ2(x[2],W,Q2,epsilon+delta);
+	val*=dsigma_costh;
+	//additional (not real photo) Q2dependence of cross section
+	if(TMath::IsNaN(val)) return 0.;
+	if(val<0) return 0.;
+	val*=Q2WModel->Q2H1Rho(Q2);
+	return val;
+      };
+  }
+  //////////////////////////////////////////////////////////////////////////
+  ///Foam in ln(x), ln(y) and cos(theta) for the generation W range
+  void ElectronScattering::InitFoam(){
+    auto photonFlux= dynamic_cast<ScatteredElectron_xy* >(mutableDecayer());
+    auto gStarModel = _gStarN!=nullptr ? dynamic_cast<DecayModelst*>(_gStarN->Model()) : nullptr;
+    auto gStarDecayer = _gStarN!=nullptr ? dynamic_cast<const TwoBodyFlat*>(_gStarN->Decayer()) : nullptr;
+    if(photonFlux==nullptr || gStarModel==nullptr || gStarDecayer==nullptr
+       || dynamic_cast<DecayModelQ2W*>(Model())==nullptr){
+      std::cerr<<"ElectronScattering::InitFoam need ScatteredElectron_xy, DecayModelQ2W and a DecayModelst g*N decay with two body decay vectors, exiting..."<<std::endl;
+      exit(0);
+    }
+    if(gStarModel->GetMeson()->MassDistribution()!=nullptr || gStarModel->GetBaryon()->MassDistribution()!=nullptr)
+      std::cout<<"ElectronScattering::InitFoam warning the foam is built at fixed meson and baryon masses, their mass dependence of dsigma/dcos(theta) beyond MassPhaseSpace is not included"<<std::endl;
+    
+    MakeCollision();
+    auto& flux=photonFlux->Dist();
+    _foam.reset(new FoamSampler({flux.GetMinLnX(),flux.GetMinLnY(),-1},
+				{flux.GetMaxLnX(),flux.GetMaxLnY(),1},CrossSectionIntegrand()));
+    _foam->SetCells(_foamCells);
+    _foam->SetSamplesPerCell(_foamSamples);
+    _foam->SetWeighted(generator().WeightedEvents());
+
+    gBenchmark->Start("FoamInit");
+    _foam->Initialize();
+    gBenchmark->Stop("FoamInit");
+    gBenchmark->Print("FoamInit");
+
+    //foam already follows the Q2W and g*N intensities
+    SetSampledExternally();
+    _gStarN->SetSampledExternally();
+  }
+  //////////////////////////////////////////////////////////////////////////
+  ///Give the foam point to the e' and g*N decay vectors and
+  ///generate the chain, new point if it fails e.g. below threshold
+  void ElectronScattering::GenerateFromFoam(){
+    auto photonFlux= dynamic_cast<ScatteredElectron_xy* >(mutableDecayer());
+    auto gStarDecayer= dynamic_cast<const TwoBodyFlat*>(_gStarN->Decayer());
+    double x[3];
+    while(true){
+      MakeCollision();
+      _samplerWeight=_foam->Sample(x);
+      photonFlux->SetNextXY(TMath::Exp(x[0]),TMath::Exp(x[1]));
+      gStarDecayer->SetNextCosTh(x[2]);
+      if(DecayingParticle::GenerateProducts()==DecayStatus::Decayed) break;
+      _nsamples++;
+    }
+  }
+
   LorentzVector ElectronScattering::MakeCollision(){
     //Generate collision 4-momentum
     if(_electronptr!=nullptr){
@@ -312,95 +416,78 @@ namespace elSpectro{
     return collision;
   }
   //////////////////////////////////////////////////////////////////////////
-  ///Use RooFit integrator to integrate cross section over x , y and t
+  ///Use adaptive Monte Carlo (VegasIntegrator) to integrate cross section
+  ///over ln(x) , ln(y) and cos(theta). Integrand moves the reaction
+  ///particles so is evaluated on this thread only
   double ElectronScattering::IntegrateCrossSection(){
+
+    if(_cacheIntegrals && _xsIntegrator.get()!=nullptr)
+      return _xsIntegrator->Integral();
     
     auto collision=MakeCollision();
- 
 
-    auto photonFlux= dynamic_cast<ScatteredElectron_xy* >(mutableDecayer());
-
-    auto xvar = RooRealVar(Form("xIntegral%lf_%lf",photonFlux->Dist().GetMaxLnX(),photonFlux->Dist().GetMaxLnX()),"xIntegral",(photonFlux->Dist().GetMinLnX()),(photonFlux->Dist().GetMinLnX()),(photonFlux->Dist().GetMaxLnX()),"");
-    auto yvar = RooRealVar(Form("yIntegral%lf_%lf",photonFlux->Dist().GetMaxLnY(),photonFlux->Dist().GetMaxLnY()),"yIntegral",(photonFlux->Dist().GetMinLnY()),(photonFlux->Dist().GetMinLnY()),(photonFlux->Dist().GetMaxLnY()),"");
 
-
-    
-     auto cthvar = RooRealVar("CosThIntegral","CosThIntegral",0.99,-1,1,"");
+    auto photonFlux= dynamic_cast<ScatteredElectron_xy* >(mutableDecayer());
     
     auto gStarModel =dynamic_cast<DecayModelst*>(_gStarN->Model());
     auto Q2WModel =dynamic_cast<DecayModelQ2W*>(Model());
+
+    //model parameters are in the cache configuration, add kinematics
+    auto& cache=generator().Cache();
+    InitCache::context_t context{_nuclRestElec.E(),_Wmin,collision.M(),_integralPrecision,
+	gStarModel->GetMeson()->PdgMass(),gStarModel->GetBaryon()->PdgMass()};
+    double cachedIntegral=0;
+    if(cache.Get("ElectronScattering::IntegrateCrossSection",context,cachedIntegral))
+      return cachedIntegral;
     
     photonFlux->Dist().SetWThresholdVal(gStarModel->GetMeson()->PdgMass()+gStarModel->GetBaryon()->PdgMass());
 
-    auto Eel=_nuclRestElec.E();
+    auto fXYcosth = CrossSectionIntegrand();
 
-    double_t threshW= gStarModel->GetMeson()->PdgMass()+gStarModel->GetBaryon()->PdgMass();
-    Double_t maxVal=0;
-    auto fXYcosth = [this,&photonFlux,&gStarModel,&Q2WModel,&Eel,&threshW,&maxVal](const double *x)
-      {
-	if(x[0]==0) return 0.; //x
-	if(x[1]==0) return 0.; //y
-	auto val = photonFlux->Dist().Eval(x);
-	if(TMath::IsNaN(val)) return 0.;
-	if(val==0) return 0.;
-	//calculate scatered electron at x and y 
-	photonFlux->GenerateGivenXandY(P4(),Model()->Products(),TMath::Exp(x[0]),TMath::Exp(x[1]));
-	//calculate virtual photon
-	Q2WModel->Intensity();
-	//get value of dsigma(s)/dcosth cross section at x,y,costh
-	Double_t dsigma_costh=gStarModel->dsigma_costh(x[2]);
-	val*=dsigma_costh;
-	//additional (not real photo) Q2dependence of cross section
-	if(TMath::IsNaN(val)) return 0.;
-	if(val<0) return 0.;
-	val*=Q2WModel->Q2H1Rho();
-	return val;
-      };
-  
-    auto wrapPdf=ROOT::Math::Functor( fXYcosth , 3);
-
-    //Append integral number to name to prevent RooFit cahce if not wanted
-    //Note call SetCacheIntegrals() to use cahced values
-    TString pdfname(Form("ElScatterIntegral%d",NintegralsElectronScattering));
-    auto pdf = RooFunctorPdfBinding(pdfname, "ElScatterIntegral", wrapPdf, RooArgList(xvar,yvar,cthvar));
-    if(_cacheIntegrals==0) NintegralsElectronScattering++;//work around RooFit agressive caching!
-    // pdf->Print();
+    _xsIntegrator.reset(new VegasIntegrator({photonFlux->Dist().GetMinLnX(),photonFlux->Dist().GetMinLnY(),-1},
+					     {photonFlux->Dist().GetMaxLnX(),photonFlux->Dist().GetMaxLnY(),1}));
+    //the integrand has its own kinematics, the g*N model may not
+    _xsIntegrator->SetFunction(fXYcosth,gStarModel->CanEvaluateConcurrently());
+    _xsIntegrator->SetPrecision(_integralPrecision);
     
-    auto roovars= RooArgSet(xvar,yvar,cthvar);
-     
- 
-    gBenchmark->Start("RooFitIntegral");
+    gBenchmark->Start("VegasIntegral");
 
-    auto RFintegral=pdf.getNorm(roovars);
+    auto integral=_xsIntegrator->Integrate();
   
-    gBenchmark->Stop("RooFitIntegral");
-    gBenchmark->Print("RooFitIntegral");
+    gBenchmark->Stop("VegasIntegral");
+    gBenchmark->Print("VegasIntegral");
      
-    std::cout<<" ElectronScattering::IntegrateCrossSection()  "<<RFintegral<<" nb "<<std::endl<<" giving a photon flux weighted average photoproduction cross section of "<<RFintegral/photonFlux->Dist().Integral()<<" nb"<<std::endl;
+    std::cout<<" ElectronScattering::IntegrateCrossSection()  "<<integral<<" +- "<<_xsIntegrator->Error()<<" nb "<<std::endl<<" giving a photon flux weighted average photoproduction cross section of "<<integral/photonFlux->Dist().Integral()<<" nb"<<std::endl;
     std::cout<<" W range "<<_Wmin<<" - "<< collision.M() <<" =  "<< ( collision.M()- _Wmin)<<std::endl;
-    //xvar.Print();
-    //yvar.Print();
-    //cthvar.Print();
     
     photonFlux->Dist().SetWThresholdVal(Q2WModel->getThreshold());
+    cache.Put("ElectronScattering::IntegrateCrossSection",context,integral);
    
-    return RFintegral;
+    return integral;
   }
 /////////////////////////////////////////////////////////////////////////
   DecayStatus  ElectronScattering::GenerateProducts(){
 
-    auto collision=MakeCollision();
+    if(_foam.get()!=nullptr) GenerateFromFoam();
+    else{
+      auto collision=MakeCollision();
     
-    //proceed through decay chain
-    while(DecayingParticle::GenerateProducts()!=DecayStatus::Decayed){
-      _nsamples++;
-      collision=MakeCollision();
-    }//DecayModelQ2W
+      //proceed through decay chain
+      while(DecayingParticle::GenerateProducts()!=DecayStatus::Decayed){
+	_nsamples++;
+	collision=MakeCollision();
+      }//DecayModelQ2W
+    }
     
      
+    //still in nucleon rest frame
+    auto kinematics=Kinematics(_reactionInfo);
+    
     //Boost all stable particles back to lab
     auto prBoost=_beamNucl.P4().BoostToCM();
     Manager::Instance().Particles().BoostStable(-prBoost);
+
+    FillEventRecord(kinematics);
     //Manager::Instance().Particles().BoostToFrame(-prBoost,collision);
    
     return DecayStatus::Decayed;
@@ -10,11 +10,16 @@
 ///             3) DecayModelQ2W for e'(g*p) production
 ///                to some final state e.g. e'rho+p
 ///                (e' probably remains unchanged)           
+///             UseFoam() samples ln(x),ln(y),cos(theta) together
+///             from the cross section instead of the flux, W and
+///             t envelopes in turn
 
 #pragma once
 #include "ProductionProcess.h"
 #include "PhaseSpaceDecay.h"
 #include "FunctionsForElectronScattering.h"
+#include "VegasIntegrator.h"
+#include "FoamSampler.h"
 
 #include <TMath.h> //for Pi()
 
@@ -24,8 +29,6 @@ namespace elSpectro{
   class ElectronScattering : public ProductionProcess {
 
   public:
-    static int NintegralsElectronScattering;// keep track of number of integrations in same root sesssion
-
     //or if decayer already give required distribution
    
     /*  ElectronScattering(double ep,double ionp,
@@ -45,6 +48,7 @@ namespace elSpectro{
 
  
     void InitGen() override;
+    void Print() const override;
 
     double W2Max()const noexcept{
       return  sqrt(_massIon*_massIon + 2 * (_nuclRestElec.E() -escat::M_el())
@@ -76,9 +80,31 @@ namespace elSpectro{
     double IntegrateCrossSectionFast() override;
     LorentzVector MakeCollision();
 
+    //reuse the last IntegrateCrossSection result
     void SetCacheIntegrals(int doit=1){_cacheIntegrals=doit;}
+    //relative error at which IntegrateCrossSection stops
+    void SetIntegralPrecision(double relerr){_integralPrecision=relerr;}
+    //trained by IntegrateCrossSection, can be used as a proposal
+    //density in ln(x),ln(y),cos(theta)
+    const VegasIntegrator* CrossSectionIntegrator()const noexcept{return _xsIntegrator.get();}
+
+    //propose events from a TFoam of the IntegrateCrossSection integrand,
+    //built in InitGen. The g*N decay is not accept/rejected, meson and
+    //baryon masses are still sampled by MassPhaseSpace
+    void UseFoam(int ncells=1000,int nsamples=200){
+      _foamCells=ncells;
+      _foamSamples=nsamples;
+    }
+    const FoamSampler* Foam()const noexcept{return _foam.get();}
     
   private:
+
+    //dsigma/dlnx/dlny/dcos(theta) at {lnx,lny,costh}
+    //leaves the reaction particles alone, thread safe when the
+    //g*N model CanEvaluateConcurrently
+    std::function<double(const double*)> CrossSectionIntegrand();
+    void InitFoam();
+    void GenerateFromFoam();
     
     ElectronScattering()=delete;
 
@@ -112,10 +138,14 @@ namespace elSpectro{
     double _Ymax={0};
 
     
-    long _nsamples=0;
     int _pdgIon={2212}; //species of ion
 
     short _cacheIntegrals={0};
+    double _integralPrecision={1E-3};
+    std::unique_ptr<VegasIntegrator> _xsIntegrator;//!
+    std::unique_ptr<FoamSampler> _foam;//!
+    int _foamCells={0};
+    int _foamSamples={200};
     
     DecayingParticle* _gStarN={nullptr}; 
     CollidingParticle* _electronptr={nullptr};
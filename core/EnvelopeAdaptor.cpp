@@ -0,0 +1,43 @@
+#include "EnvelopeAdaptor.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  ///////////////////////////////////////////////////////////
+  void EnvelopeAdaptor::SetRange(double xmin,double xmax,int nbins){
+    _xmin=xmin;
+    _xmax=xmax;
+    if( !(xmax>xmin) || std::isfinite(xmax-xmin)==false || nbins<1 ) nbins=1;
+    _scale.assign(nbins,1.);
+  }
+  ///////////////////////////////////////////////////////////
+  size_t EnvelopeAdaptor::Bin(double x) const noexcept{
+    if(_scale.size()==1) return 0;
+    auto ib=std::floor((x-_xmin)/(_xmax-_xmin)*_scale.size());
+    if( !(ib>0) ) return 0;
+    return std::min(static_cast<size_t>(ib),_scale.size()-1);
+  }
+  ///////////////////////////////////////////////////////////
+  ///min(ratio/k,1)*max(ratio,k) = ratio for any k
+  double EnvelopeAdaptor::AcceptReject(double x,double ratio,double u,long long event){
+    auto& k=_scale[Bin(x)];
+    if(ratio>k){
+      if(_exceeded.size()<10)
+	std::cout<<"EnvelopeAdaptor::AcceptReject envelope exceeded at "<<x<<" by "<<ratio/k<<" in event "<<event<<", raising bound and weighting event "<<std::endl;
+      _exceeded.push_back(event);
+      auto weight=ratio;
+      k=ratio*(1+_margin);
+      return weight;
+    }
+    if(ratio > u*k) return k;
+    return 0;
+  }
+  ///////////////////////////////////////////////////////////
+  void EnvelopeAdaptor::Print(const std::string& name) const{
+    if(_exceeded.empty()) return;
+    std::cout<<"\t "<<name<<" envelope raised "<<_exceeded.size()<<" times, largest scale "<<*std::max_element(_scale.begin(),_scale.end())<<std::endl;
+  }
+
+}
@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		EnvelopeAdaptor
+///Description:
+///             Accept/reject against an envelope which may be too low
+///             ratio = value/envelope, each bin of a variable x
+///             (e.g. the parent mass) has a scale k, starting at 1
+///             Accept with probability min(ratio/k,1) and give the
+///             event weight max(ratio,k), which averages to ratio
+///             so the weighted sample is exact whatever k is
+///             When ratio>k the bin scale is raised to ratio*(1+margin)
+///             for later events and the event index is recorded
+///             e.g.
+///             EnvelopeAdaptor adaptor(Wmin,Wmax);
+///             auto weight = adaptor.AcceptReject(W,val/max,rng().Uniform(),ievent);
+///             if(weight==0) reject...
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace elSpectro{
+
+  class EnvelopeAdaptor{
+
+  public:
+
+    EnvelopeAdaptor()=default;
+    EnvelopeAdaptor(double xmin,double xmax,int nbins=100){SetRange(xmin,xmax,nbins);}
+
+    //one bin if the range is not valid
+    void SetRange(double xmin,double xmax,int nbins=100);
+    void SetMargin(double margin){_margin=margin;}
+
+    //u uniform on (0,1), returns the event weight, 0 if rejected
+    double AcceptReject(double x,double ratio,double u,long long event);
+
+    double Scale(double x) const noexcept{return _scale[Bin(x)];}
+    size_t NExceeded()const noexcept{return _exceeded.size();}
+    //event indices when the envelope was raised
+    const std::vector<long long>& ExceededEvents()const noexcept{return _exceeded;}
+
+    void Print(const std::string& name) const;
+
+  private:
+
+    size_t Bin(double x) const noexcept;
+
+    std::vector<double> _scale=std::vector<double>(1,1.);
+    std::vector<long long> _exceeded;
+    double _xmin={0};
+    double _xmax={0};
+    double _margin={0.05};
+
+  };
+
+}//namespace elSpectro
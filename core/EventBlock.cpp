@@ -0,0 +1,87 @@
+#include "EventBlock.h"
+#include <iostream>
+
+namespace elSpectro{
+
+  ///////////////////////////////////////////////////////////
+  void EventBlock::Clear() noexcept{
+    _px.clear();
+    _py.clear();
+    _pz.clear();
+    _e.clear();
+    _vx.clear();
+    _vy.clear();
+    _vz.clear();
+    _vt.clear();
+    _Q2.clear();
+    _W.clear();
+    _t.clear();
+    _weight.clear();
+    _nEvents=0;
+  }
+  ///////////////////////////////////////////////////////////
+  ///particle and vertex arrays are reserved with the first event
+  void EventBlock::Reserve(size_t nevents){
+    _nReserve=nevents;
+    _Q2.reserve(nevents);
+    _W.reserve(nevents);
+    _t.reserve(nevents);
+    _weight.reserve(nevents);
+  }
+  ///////////////////////////////////////////////////////////
+  void EventBlock::AddEvent(const EventRecord& event){
+    const auto& particles=event.Particles();
+    const auto& vertices=event.Vertices();
+
+    if(_nEvents==0){
+      //layout of this reaction
+      _pdg.clear();
+      _status.clear();
+      _parent.clear();
+      _vertex.clear();
+      for(const auto& p:particles){
+	_pdg.push_back(p._pdg);
+	_status.push_back(p._status);
+	_parent.push_back(p._parent);
+	_vertex.push_back(p._vertex);
+      }
+      _nVertices=vertices.size();
+
+      const auto npart=_nReserve*NParticles();
+      _px.reserve(npart);
+      _py.reserve(npart);
+      _pz.reserve(npart);
+      _e.reserve(npart);
+      const auto nvert=_nReserve*_nVertices;
+      _vx.reserve(nvert);
+      _vy.reserve(nvert);
+      _vz.reserve(nvert);
+      _vt.reserve(nvert);
+    }
+    else if(particles.size()!=NParticles() || vertices.size()!=_nVertices){
+      std::cerr<<"EventBlock::AddEvent events have different particles, exiting..."<<std::endl;
+      exit(0);
+    }
+
+    for(const auto& p:particles){
+      _px.push_back(p._p4.X());
+      _py.push_back(p._p4.Y());
+      _pz.push_back(p._p4.Z());
+      _e.push_back(p._p4.T());
+    }
+    for(const auto& v:vertices){
+      _vx.push_back(v.X());
+      _vy.push_back(v.Y());
+      _vz.push_back(v.Z());
+      _vt.push_back(v.T());
+    }
+    const auto& kin=event.Kinematics();
+    _Q2.push_back(kin._Q2);
+    _W.push_back(kin._W);
+    _t.push_back(kin._t);
+    _weight.push_back(event.Weight());
+
+    ++_nEvents;
+  }
+
+}
@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		EventBlock
+///Description:
+///             Many events in structure-of-arrays form for
+///             vectorised analysis, filled by Manager::GenerateBatch
+///             Every event of a reaction has the same particles, so
+///             particle ip of event iev is at index iev*NParticles()+ip
+///             in Px(),Py(),Pz(),E() and vertex iv at iev*NVertices()+iv
+///             in VX(),VY(),VZ(),VT(). Pdg(),Status() and Parent() are
+///             per particle, Q2(),W(),T() and Weight() per event
+///             e.g.
+///             while(finishedGenerator()==false){
+///               auto& block=generateBatch(10000);
+///               auto np=block.NParticles();
+///               for(size_t iev=0;iev<block.NEvents();++iev)
+///                 hist.Fill(block.Pz()[iev*np+2],block.Weight()[iev]);
+///             }
+#pragma once
+
+#include "EventRecord.h"
+#include <vector>
+
+namespace elSpectro{
+
+  class EventBlock{
+
+  public:
+
+    //keeps capacity for the next block
+    void Clear() noexcept;
+    void Reserve(size_t nevents);
+    void AddEvent(const EventRecord& event);
+
+    size_t NEvents()const noexcept{return _nEvents;}
+    size_t NParticles()const noexcept{return _pdg.size();}
+    size_t NVertices()const noexcept{return _nVertices;}
+
+    //per particle of every event
+    const std::vector<double>& Px()const noexcept{return _px;}
+    const std::vector<double>& Py()const noexcept{return _py;}
+    const std::vector<double>& Pz()const noexcept{return _pz;}
+    const std::vector<double>& E()const noexcept{return _e;}
+    //per vertex of every event
+    const std::vector<double>& VX()const noexcept{return _vx;}
+    const std::vector<double>& VY()const noexcept{return _vy;}
+    const std::vector<double>& VZ()const noexcept{return _vz;}
+    const std::vector<double>& VT()const noexcept{return _vt;}
+    //per particle, same for all events
+    const std::vector<int>& Pdg()const noexcept{return _pdg;}
+    const std::vector<RecordStatus>& Status()const noexcept{return _status;}
+    const std::vector<int>& Parent()const noexcept{return _parent;}
+    const std::vector<int>& Vertex()const noexcept{return _vertex;}
+    //per event
+    const std::vector<double>& Q2()const noexcept{return _Q2;}
+    const std::vector<double>& W()const noexcept{return _W;}
+    const std::vector<double>& T()const noexcept{return _t;}
+    const std::vector<double>& Weight()const noexcept{return _weight;}
+
+  private:
+
+    std::vector<double> _px;
+    std::vector<double> _py;
+    std::vector<double> _pz;
+    std::vector<double> _e;
+
+    std::vector<double> _vx;
+    std::vector<double> _vy;
+    std::vector<double> _vz;
+    std::vector<double> _vt;
+
+    std::vector<int> _pdg;
+    std::vector<RecordStatus> _status;
+    std::vector<int> _parent;
+    std::vector<int> _vertex;
+
+    std::vector<double> _Q2;
+    std::vector<double> _W;
+    std::vector<double> _t;
+    std::vector<double> _weight;
+
+    size_t _nEvents={0};
+    size_t _nVertices={0};
+    size_t _nReserve={0};
+
+  };
+
+}//namespace elSpectro
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		EventRecord
+///Description:
+///             Flat copy of the particles, vertices, weight and
+///             production kinematics (Q2,W,t) of one event
+///             It does not point to the live Particle objects so it
+///             stays valid while the next event is generated,
+///             e.g. for writing output on another thread
+///             Built once per accepted event by ProductionProcess and
+///             available from Manager::CurrentEvent()
+///             Particles are stored initial, decaying, final
+///             _parent gives the index of the decaying particle which
+///             produced a particle, -1 for the primary reaction
+#pragma once
+
+#include "DecayingParticle.h"
+#include <vector>
+
+namespace elSpectro{
+
+  //Decayed = decaying particle at its production vertex
+  //Detached = decaying particle with its own decay vertex
+  enum class RecordStatus{ Initial, Decayed, Detached, Final };
+
+  struct RecordParticle{
+    LorentzVector _p4;
+    double _mass={0};
+    int _pdg={0};
+    RecordStatus _status={RecordStatus::Final};
+    int _vertex={0}; //production vertex
+    int _decayVertex={-1}; //detached decaying particles only
+    int _parent={-1}; //index in EventRecord::Particles()
+  };
+
+  //invariants of the meson production, 0 if not known
+  struct ReactionKinematics{
+    double _Q2={0};
+    double _W={0};
+    double _t={0};
+  };
+
+  class EventRecord{
+
+  public:
+
+    void Clear() noexcept{
+      _particles.clear();
+      _vertices.clear();
+      _weight=1;
+      _kinematics=ReactionKinematics{};
+    }
+
+    void AddParticle(const Particle* p,RecordStatus status,int parent=-1){
+      RecordParticle rp;
+      rp._p4=p->P4();
+      rp._mass=p->Mass();
+      rp._pdg=p->Pdg();
+      rp._status=status;
+      rp._vertex=p->VertexID();
+      rp._parent=parent;
+      if(status==RecordStatus::Detached)
+	rp._decayVertex=static_cast<const DecayingParticle*>(p)->DecayVertexID();
+      _particles.push_back(rp);
+    }
+    void AddVertex(const LorentzVector& pos){_vertices.push_back(pos);}
+
+    //decaying particles are not boosted with the stable ones,
+    //take their momentum from their products instead
+    //parents come before their products so work backwards
+    void SumDecayProducts(){
+      for(int i=static_cast<int>(_particles.size())-1;i>=0;--i){
+	auto& parent=_particles[i];
+	if(parent._status!=RecordStatus::Decayed) continue;
+	LorentzVector sum;
+	bool found=false;
+	for(const auto& p:_particles)
+	  if(p._parent==i){sum+=p._p4;found=true;}
+	if(found) parent._p4=sum;
+      }
+    }
+    void SetWeight(double w) noexcept{_weight=w;}
+    double Weight()const noexcept{return _weight;}
+    void SetKinematics(const ReactionKinematics& kin) noexcept{_kinematics=kin;}
+    const ReactionKinematics& Kinematics()const noexcept{return _kinematics;}
+
+    const std::vector<RecordParticle>& Particles()const noexcept{return _particles;}
+    const std::vector<LorentzVector>& Vertices()const noexcept{return _vertices;}
+
+    size_t NParticles(RecordStatus status)const noexcept{
+      size_t n=0;
+      for(const auto& p:_particles) if(p._status==status) ++n;
+      return n;
+    }
+
+  private:
+
+    std::vector<RecordParticle> _particles;
+    std::vector<LorentzVector> _vertices;
+    double _weight={1};
+    ReactionKinematics _kinematics;
+
+  };
+
+}//namespace elSpectro
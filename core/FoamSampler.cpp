@@ -0,0 +1,89 @@
+#include "FoamSampler.h"
+#include "ThreadRandom.h"
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  namespace{
+    //TFoam samples the unit cube, map it onto the box
+    class BoxDensity : public TFoamIntegrand{
+    public:
+      BoxDensity(const std::vector<double>& lower,const std::vector<double>& upper,
+		 FoamSampler::function_t f):
+	_lower{lower},_upper{upper},_x(lower.size()),_func{f}
+      {
+	for(size_t id=0;id<_lower.size();++id) _volume*=_upper[id]-_lower[id];
+      }
+      Double_t Density(Int_t ndim,Double_t* u) final{
+	for(int id=0;id<ndim;++id) _x[id]=_lower[id]+u[id]*(_upper[id]-_lower[id]);
+	auto val=_func(_x.data());
+	if(std::isnan(val) || val<0) return 0;
+	return val*_volume;
+      }
+    private:
+      std::vector<double> _lower;
+      std::vector<double> _upper;
+      std::vector<double> _x;
+      FoamSampler::function_t _func;
+      double _volume={1};
+    };
+  }
+
+  ///////////////////////////////////////////////////////////
+  FoamSampler::FoamSampler(const std::vector<double>& lower,const std::vector<double>& upper,function_t f):
+    _lower{lower},
+    _upper{upper},
+    _unit(lower.size()),
+    _ndim(lower.size())
+  {
+    if(_lower.size()!=_upper.size() || _ndim==0 || !f){
+      std::cerr<<"FoamSampler::FoamSampler need a function and lower and upper limits in each dimension, exiting..."<<std::endl;
+      exit(0);
+    }
+    _density.reset(new BoxDensity{_lower,_upper,f});
+  }
+  FoamSampler::~FoamSampler()=default;
+
+  ///////////////////////////////////////////////////////////
+  void FoamSampler::Initialize(){
+    _foam.reset(new TFoam("elSpectroFoam"));
+    _foam->SetkDim(_ndim);
+    _foam->SetnCells(_nCells);
+    _foam->SetnSampl(_nSamples);
+    _foam->SetOptRej(_weighted ? 0 : 1);
+    _foam->SetMaxWtRej(_maxWeight);
+    _foam->SetChat(0);
+    _foam->SetRho(_density.get());
+    _foam->SetPseRan(threadRandom());
+    _foam->Initialize();
+    std::cout<<"FoamSampler::Initialize() "<<_nCells<<" cells in "<<_ndim<<" dimensions, integral "<<Integral()<<std::endl;
+  }
+  ///////////////////////////////////////////////////////////
+  double FoamSampler::Sample(double* x){
+    _foam->MakeEvent();
+    _foam->GetMCvect(_unit.data());
+    for(int id=0;id<_ndim;++id) x[id]=_lower[id]+_unit[id]*(_upper[id]-_lower[id]);
+    ++_nSampled;
+    return _foam->GetMCwt();
+  }
+  ///////////////////////////////////////////////////////////
+  double FoamSampler::Integral() const{
+    if(_foam.get()==nullptr) return 0;
+    double integral=0;
+    double error=0;
+    _foam->GetIntegMC(integral,error);
+    if(integral==0) _foam->GetIntNorm(integral,error);//no samples yet
+    return integral;
+  }
+  ///////////////////////////////////////////////////////////
+  double FoamSampler::Efficiency() const{
+    if(_foam.get()==nullptr || _nSampled==0) return 0;
+    double average=0;
+    double max=0;
+    double sigma=0;
+    _foam->GetWtParams(0.0005,average,max,sigma);
+    return max>0 ? average/max : 0;
+  }
+
+}
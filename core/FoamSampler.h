@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		FoamSampler
+///Description:
+///             Multi-dimensional proposal from ROOT's TFoam
+///             (Jadach, cell based self-adapting sampler)
+///             The box lower-upper is split into cells which are
+///             refined where the function varies most, so correlations
+///             between the variables are followed, unlike a product of
+///             1D envelopes. The function is evaluated on this thread
+///             Sample(x) returns the weight of x, 1 (or above 1 where
+///             the foam underestimates the function) unless weighted
+///             e.g.
+///             FoamSampler foam({0,-1},{1,1},[](const double* x){...});
+///             foam.SetCells(2000);
+///             foam.Initialize();
+///             auto weight = foam.Sample(x);
+#pragma once
+
+#include <TFoam.h>
+#include <TFoamIntegrand.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace elSpectro{
+
+  class FoamSampler{
+
+  public:
+
+    using function_t = std::function<double(const double*)>;
+
+    FoamSampler(const std::vector<double>& lower,const std::vector<double>& upper,function_t f);
+    ~FoamSampler();
+    FoamSampler(const FoamSampler& other)=delete;
+    FoamSampler& operator=(const FoamSampler& other)=delete;
+
+    //set before Initialize
+    void SetCells(int n){_nCells=n;}
+    void SetSamplesPerCell(int n){_nSamples=n;}
+    //weighted => keep every proposal with weight f/density
+    //else accept/reject against maxWeight*average weight
+    void SetWeighted(bool weighted=true){_weighted=weighted;}
+    void SetMaxWeight(double max){_maxWeight=max;}
+
+    //build the cells, calls f about cells*samples times
+    void Initialize();
+
+    //draw x with rng(), returns its weight
+    double Sample(double* x);
+
+    //integral of f over the box from the foam exploration
+    double Integral() const;
+    //average/maximum weight of the samples so far
+    double Efficiency() const;
+    long NSampled()const noexcept{return _nSampled;}
+    int NDim()const noexcept{return _ndim;}
+
+  private:
+
+    std::unique_ptr<TFoamIntegrand> _density;//!
+    std::unique_ptr<TFoam> _foam;//!
+    std::vector<double> _lower;
+    std::vector<double> _upper;
+    std::vector<double> _unit;
+
+    double _maxWeight={1.1};
+    long _nSampled={0};
+    int _ndim={0};
+    int _nCells={1000};
+    int _nSamples={200};
+    bool _weighted={false};
+
+  };
+
+}//namespace elSpectro
@@ -1,11 +1,11 @@
 #include "FunctionsForJpac.h"
+#include "ThreadRandom.h"
 
 #include <Math/GSLIntegrator.h>
 #include <Math/IntegrationTypes.h>
 #include <Math/Functor.h>
 #include <Math/Minimizer.h>
 #include <Math/Factory.h>
-#include <TRandom3.h>
 
 namespace elSpectro {
 
@@ -128,8 +128,8 @@ namespace elSpectro {
       auto mint= xs[1];
       /*
       for(int i=0;i<4;i++){
-	auto valW=gRandom->Uniform(TMath::Sqrt(amp->_kinematics->sth),Wmax);
-	auto valt=gRandom->Uniform(tmax,0);
+	auto valW=rng().Uniform(TMath::Sqrt(amp->_kinematics->sth),Wmax);
+	auto valt=rng().Uniform(tmax,0);
 	std::cout<<"Starting values "<<valW<<" "<<valt<<std::endl;
 	minimum->SetVariableValue(0,valW);
 	minimum->SetVariableValue(1,valt);
@@ -24,6 +24,12 @@ namespace elSpectro {
       return TMath::Sqrt( kine::PDK2(a,b,c) );
     }
 
+    //CM momentum squared of a virtual photon, mass^2=-Q2, on target M
+    inline double PDK2VirtualPhoton(double W, double Q2, double M){
+      double a = W*W + Q2 - M*M;
+      return (a*a + 4*Q2*M*M)/(4*W*W);
+    }
+
     inline double PhaseSpaceWeightMax(double W, const std::vector<double>& masses){
 
       //subtract masses from W to get TCM
@@ -124,6 +130,16 @@ namespace elSpectro {
       return  t0(W,M1,M2,M3,M4) - 4*p1*p3 ; 
       
     }
+    //t0 for a virtual photon with target M2 producing M3 and M4
+    //tmax is t0-4*p1*p3 as for real photons
+    inline double t0VirtualPhoton(double W,double Q2,double M2,double M3,double M4){
+      double p1 = sqrt(PDK2VirtualPhoton(W,Q2,M2));
+      double p3 = PDK(W,M3,M4);
+      
+      double E1 = (W*W - Q2 - M2*M2)/(2*W);
+      double E3 = sqrt(M3*M3 + p3*p3);
+      return -Q2 + M3*M3  - 2 * ( E1*E3 -p1*p3 ); 
+    }
     inline double costhFromt(double t, double W,double M1,double M2,double M3,double M4){
       //if(M1!=0)exit(0);
       double p1 = PDK(W,M1,M2);
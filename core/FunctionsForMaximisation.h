@@ -0,0 +1,126 @@
+#pragma once
+
+#include "FunctionsForThreads.h"
+#include <Math/Functor.h>
+#include <Math/Minimizer.h>
+#include <Math/Factory.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace elSpectro {
+
+  namespace maximise {
+
+    struct MaxResult{
+      std::vector<double> _x; //where _max was found
+      double _max={0};  //largest value found
+      double _bound={0}; //_max or larger if an unexplored region may beat it
+      double _margin={0}; //fraction local fits gained on their grid point
+    };
+
+    //Global maximum of f(const double* x) for lower<=x<=upper
+    //1) f on a grid of npoints per dimension, shared between threads
+    //   if concurrent, so f must then be safe to call from any thread
+    //2) local fits started from the nstarts largest local maxima of the grid
+    //3) the gain of the fits over their grid points (margin) shows how much
+    //   the grid underestimates a peak, grid points not fitted are allowed
+    //   the same gain when calculating the bound
+    template<typename F>
+    MaxResult multiStart(F f,const std::vector<double>& lower,const std::vector<double>& upper,
+			 int npoints=50,int nstarts=8,bool concurrent=true){
+      const int ndim=lower.size();
+      auto eval=[&f](const double* x){
+	auto val=f(x);
+	return std::isnan(val) ? 0. : val;
+      };
+
+      std::vector<double> step(ndim);
+      int ngrid=1;
+      for(int id=0;id<ndim;++id){
+	step[id]=(upper[id]-lower[id])/npoints;
+	ngrid*=npoints;
+      }
+      //cell centres so boundaries where f may be undefined are avoided
+      auto gridPoint=[&](int ig,double* x){
+	for(int id=0;id<ndim;++id){
+	  x[id]=lower[id]+(ig%npoints+0.5)*step[id];
+	  ig/=npoints;
+	}
+      };
+
+      std::vector<double> grid(ngrid);
+      threads::parallelFor(ngrid,[&](int ig){
+	  std::vector<double> x(ndim);
+	  gridPoint(ig,x.data());
+	  grid[ig]=eval(x.data());
+	},concurrent);
+
+      //grid points larger than all their neighbours
+      std::vector<int> peaks;
+      for(int ig=0;ig<ngrid;++ig){
+	if(grid[ig]<=0) continue;
+	bool isPeak=true;
+	int stride=1;
+	for(int id=0;id<ndim && isPeak;++id){
+	  int i=(ig/stride)%npoints;
+	  if(i>0 && grid[ig-stride]>grid[ig]) isPeak=false;
+	  if(i<npoints-1 && grid[ig+stride]>grid[ig]) isPeak=false;
+	  stride*=npoints;
+	}
+	if(isPeak) peaks.push_back(ig);
+      }
+      std::sort(peaks.begin(),peaks.end(),[&grid](int l,int r){return grid[l]>grid[r];});
+
+      MaxResult result;
+      result._x.resize(ndim);
+      if(peaks.empty()){
+	gridPoint(0,result._x.data());
+	return result;
+      }
+
+      std::unique_ptr<ROOT::Math::Minimizer> minimum{ROOT::Math::Factory::CreateMinimizer("Minuit2", "")};
+      if(minimum.get()==nullptr) //Minuit2 not always installed!
+	minimum.reset(ROOT::Math::Factory::CreateMinimizer("Minuit", ""));
+      minimum->SetMaxFunctionCalls(100000);
+      minimum->SetTolerance(0.0001);
+      minimum->SetPrintLevel(0);
+
+      auto negf=[&eval](const double* x){return -eval(x);};
+      ROOT::Math::Functor wrapf(negf,ndim);
+      minimum->SetFunction(wrapf);
+
+      int nfits=std::min(nstarts,static_cast<int>(peaks.size()));
+      std::vector<double> x(ndim);
+      for(int ifit=0;ifit<nfits;++ifit){
+	auto gridVal=grid[peaks[ifit]];
+	gridPoint(peaks[ifit],x.data());
+	if(gridVal>result._max){
+	  result._max=gridVal;
+	  result._x=x;
+	}
+	for(int id=0;id<ndim;++id)
+	  minimum->SetLimitedVariable(id,"x"+std::to_string(id),x[id],step[id]/2,lower[id],upper[id]);
+	minimum->Minimize();
+
+	auto fitVal=-minimum->MinValue();
+	if(fitVal<=gridVal) continue;
+	result._margin=std::max(result._margin,fitVal/gridVal-1);
+	if(fitVal>result._max){
+	  result._max=fitVal;
+	  result._x.assign(minimum->X(),minimum->X()+ndim);
+	}
+      }
+
+      result._bound=result._max;
+      if(nfits<static_cast<int>(peaks.size()))
+	result._bound=std::max(result._bound,grid[peaks[nfits]]*(1+result._margin));
+
+      return result;
+    }
+
+  }//namespace maximise
+
+}//namespace elSpectro
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cmath>
+
+namespace elSpectro {
+
+  namespace sampling {
+
+    //t in [0,1] distributed as a*(1-t)+b*t, a,b>=0, from uniform u
+    //inverts the CDF (a*t+(b-a)*t*t/2)/((a+b)/2) in a form stable for a~b
+    inline double linearFraction(double a,double b,double u) noexcept{
+      if(a+b<=0) return u;
+      return u*(a+b)/(a+std::sqrt(a*a+u*(b*b-a*a)));
+    }
+
+  }//namespace sampling
+
+}//namespace elSpectro
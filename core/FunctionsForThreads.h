@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace elSpectro {
+
+  namespace threads {
+
+    //number of processes sharing the cores, e.g. forked jobs
+    inline int& nJobs(){
+      static int n=1;
+      return n;
+    }
+    inline void setJobs(int n){nJobs() = n>0 ? n : 1;}
+
+    //this process's share of the cores
+    inline int maxThreads(){
+      auto n = static_cast<int>(std::thread::hardware_concurrency());
+      return std::max(n/nJobs(),1);
+    }
+
+    //call f(i) for i=0..n-1 shared between up to maxThreads() threads
+    //each thread takes the next i when it is done so uneven
+    //work is balanced, f must not depend on the order of calls
+    //concurrent=false => all on the calling thread
+    template<typename F>
+    void parallelFor(int n,F f,bool concurrent=true){
+      int nthreads = concurrent ? std::min(maxThreads(),n) : 1;
+      if(nthreads<=1){
+	for(int i=0;i<n;++i) f(i);
+	return;
+      }
+
+      std::atomic<int> next={0};
+      auto work=[&next,&f,n](){
+	for(int i=next++;i<n;i=next++) f(i);
+      };
+      std::vector<std::thread> workers;
+      for(int it=1;it<nthreads;++it) workers.emplace_back(work);
+      work(); //calling thread takes part too
+      for(auto& th:workers) th.join();
+    }
+
+  }//namespace threads
+
+}//namespace elSpectro
@@ -0,0 +1,124 @@
+#include "GeneratorContext.h"
+#include <TROOT.h>
+#include <TH1.h>
+#include <TSystem.h>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace elSpectro{
+
+  namespace{
+    //building a reaction touches ROOT globals (pdg table, RooFit, TF1...)
+    //so configure functions are run one at a time
+    std::mutex configureMutex;
+  }
+
+  ///////////////////////////////////////////////////////////
+  GeneratorContext::GeneratorContext(int index,ULong64_t seed):
+    _manager{new Manager()},
+    _random{new PhiloxEngine(seed,index)}, //same seed, independent streams
+    _index{index}
+  {
+  }
+  ///////////////////////////////////////////////////////////
+  void GeneratorContext::Activate() noexcept{
+    Manager::SetCurrent(_manager.get());
+    setThreadRandomEngine(_random.get());
+  }
+  ///////////////////////////////////////////////////////////
+  void GeneratorContext::Deactivate() noexcept{
+    Manager::SetCurrent(nullptr);
+    setThreadRandomEngine(nullptr);
+  }
+
+  ///////////////////////////////////////////////////////////
+  ParallelGenerator::ParallelGenerator(int nthreads,configure_t configure):
+    _configure{configure},
+    _nthreads{nthreads>0 ? nthreads : 1}
+  {
+  }
+  ///////////////////////////////////////////////////////////
+  void ParallelGenerator::Run(){
+    ROOT::EnableThreadSafety();
+    //histograms made while building reactions should not
+    //be registered in the shared directory
+    auto addDirectory=TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+
+    //all streams must share a seed to be independent
+    if(_seed==0) _seed=PhiloxEngine{0}.GetSeed();
+    std::cout<<"ParallelGenerator::Run() seed "<<_seed<<" with "<<_nthreads<<" streams"<<std::endl;
+    
+    _contexts.clear();
+    for(int i=0;i<_nthreads;++i)
+      _contexts.push_back(std::unique_ptr<GeneratorContext>{new GeneratorContext{i,_seed}});
+
+    std::vector<std::thread> threads;
+    for(auto& context:_contexts)
+      threads.emplace_back(&ParallelGenerator::RunContext,this,std::ref(*context));
+    for(auto& th:threads)
+      th.join();
+
+    TH1::AddDirectory(addDirectory);
+
+    _stats=RunStatistics{};
+    for(const auto& context:_contexts)
+      _stats+=context->Generator().Statistics();
+
+    if(_mergedOutput.empty()==false) MergeOutputs();
+  }
+  ///////////////////////////////////////////////////////////
+  ///Equivalent of the event loop in a macro for a single context
+  void ParallelGenerator::RunContext(GeneratorContext& context){
+    context.Activate();
+    auto& gen=context.Generator();
+    {
+      std::lock_guard<std::mutex> lock(configureMutex);
+      _configure(context);
+      //configure asked for all the events, just take this share
+      gen.SetNEvents(Manager::ShareOfEvents(gen.GetNEvents(),context.Index(),_nthreads));
+    }
+
+    while(gen.Finished()==false){
+      gen.Clear();
+      gen.Reaction()->GenerateProducts();
+      gen.Write();
+      gen.CountEvent();
+    }
+    //close the shard so it can be merged
+    if(gen.GetWriter()) gen.GetWriter()->End();
+
+    context.Deactivate();
+  }
+  ///////////////////////////////////////////////////////////
+  void ParallelGenerator::MergeOutputs(){
+    std::vector<std::string> shards;
+    const Writer* mergeWriter=nullptr;
+    for(auto& context:_contexts){
+      auto wr=context->Generator().GetWriter();
+      if(wr==nullptr) continue;
+      if(mergeWriter==nullptr) mergeWriter=wr;
+      shards.push_back(wr->FileName());
+    }
+    if(mergeWriter==nullptr) return;
+
+    if(std::set<std::string>(shards.begin(),shards.end()).size()!=shards.size()){
+      std::cerr<<"ParallelGenerator::MergeOutputs contexts wrote to the same file, use GeneratorContext::ShardName for the writer, not merging"<<std::endl;
+      return;
+    }
+
+    mergeWriter->MergeShards(shards,_mergedOutput);
+    for(const auto& shard:shards)
+      if(shard!=_mergedOutput) gSystem->Unlink(shard.c_str());
+
+    std::cout<<"ParallelGenerator::MergeOutputs merged "<<shards.size()<<" shards into "<<_mergedOutput<<std::endl;
+  }
+  ///////////////////////////////////////////////////////////
+  void ParallelGenerator::Summary() const{
+    std::cout<<"ParallelGenerator::Summary() of "<<_nthreads<<" event loops"<<std::endl;
+    _stats.Print();
+  }
+
+}
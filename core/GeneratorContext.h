@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		GeneratorContext
+///Description:
+///             Owns a complete generator (Manager) and its random
+///             number stream. While active on a thread Manager::Instance()
+///             and rng() return the context's own objects
+///             so reactions built on different threads are independent.
+///
+///Class:		ParallelGenerator
+///Description:
+///             Run the same reaction in N GeneratorContexts on N threads
+///             1) configure function builds reaction, writer and
+///                calls initGenerator() as in a normal macro, it is
+///                called once per context (one at a time)
+///             2) requested events are shared between the contexts
+///                each context uses stream = index of the same seed
+///             3) writer output shards and Summary are merged at the end
+///             e.g.
+///             ParallelGenerator par(4,[](GeneratorContext& ctx){
+///                 ...build reaction...
+///                 writer(new HepMC3Writer{ctx.ShardName("out.txt")});
+///                 initGenerator();
+///                 generator().SetNEvents(1E6);
+///             });
+///             par.SetMergedOutput("out.txt");
+///             par.Run();
+///             par.Summary();
+#pragma once
+
+#include "Manager.h"
+#include "RandomEngine.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace elSpectro{
+
+  class GeneratorContext{
+
+  public:
+
+    GeneratorContext(int index=0,ULong64_t seed=0);
+
+    Manager& Generator() noexcept{return *_manager;}
+    const Manager& Generator() const noexcept{return *_manager;}
+    PhiloxEngine& Random() noexcept{return *_random;}
+    int Index()const noexcept{return _index;}
+
+    //output file name for this context e.g. out.txt => out__shard2.txt
+    std::string ShardName(const std::string& filename) const {
+      return Writer::ShardFileName(filename,_index);
+    }
+
+    //make this context current on the calling thread
+    void Activate() noexcept;
+    //return calling thread to the global Manager and default engine
+    void Deactivate() noexcept;
+
+  private:
+
+    std::unique_ptr<Manager> _manager;//!
+    std::unique_ptr<PhiloxEngine> _random;//!
+    int _index={0};
+
+  };
+
+
+  class ParallelGenerator{
+
+  public:
+
+    using configure_t = std::function<void(GeneratorContext&)>;
+
+    ParallelGenerator(int nthreads,configure_t configure);
+
+    void SetSeed(ULong64_t seed){_seed=seed;}
+    //merge the writer shards of all contexts into this file
+    void SetMergedOutput(const std::string& filename){_mergedOutput=filename;}
+
+    void Run();
+    void Summary() const;
+
+    const RunStatistics& Statistics() const noexcept{return _stats;}
+    GeneratorContext& Context(int i){return *_contexts.at(i);}
+    int NThreads()const noexcept{return _nthreads;}
+
+  private:
+
+    void RunContext(GeneratorContext& context);
+    void MergeOutputs();
+
+    configure_t _configure;//!
+    std::vector<std::unique_ptr<GeneratorContext>> _contexts;//!
+    RunStatistics _stats;
+    std::string _mergedOutput;
+
+    int _nthreads={1};
+    ULong64_t _seed={0};
+
+  };
+
+}//namespace elSpectro
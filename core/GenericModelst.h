@@ -10,6 +10,7 @@
 
 #include "DecayModelst.h"
 #include "Distribution.h"
+#include "DistTH2.h"
 
 namespace elSpectro{
 
@@ -30,6 +31,10 @@ namespace elSpectro{
       
       return _dist->GetValueFor(get_W(),get_t());
     }
+    //histogram interpolation only reads, other distributions may not
+    bool CanEvaluateConcurrently() const override {
+      return dynamic_cast<DistTH2*>(_dist.get())!=nullptr;
+    }
     
     
   private:
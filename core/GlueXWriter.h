@@ -32,8 +32,8 @@ namespace elSpectro{
      GlueXWriter& operator=(GlueXWriter&& other) = default;
      
      void WriteHeader() final{};
-     void FillAnEvent() final;
-     void Write() final;
+     using Writer::FillAnEvent;
+     void FillAnEvent(const EventRecord& event) final;
      void End() final;
      void Init() final;
      void NewFile();
@@ -41,27 +41,23 @@ namespace elSpectro{
    private:
      //streaming functions
      // output genr8 data format which can then be converted to hddm with genr8_2_hddm
-     void StreamEventInfo(){
+     void StreamEventInfo(const EventRecord& event){
        // Header (Event Info):
        // run number, event number (start counting at 1), # of Particles
   
-       _stream<< _runnumber << " " << _nEvent+1 << " " <<_finalParticles.size()<<"\n";
+       _stream<< _runnumber << " " << _nEvent+1 << " " <<event.NParticles(RecordStatus::Final)<<"\n";
      }
-     void StreamParticle(const Particle* p,int status){
+     void StreamParticle(const EventRecord& event,const RecordParticle& p,int status){
        // index, PID, mass
        // charge, P.x, P.y, P.z, E
-       auto p4=p->P4();
-       int geantCode = TDatabasePDG::Instance()->ConvertPdgToGeant3(p->Pdg());
-       int charge = TDatabasePDG::Instance()->GetParticle(p->Pdg())->Charge()/3;
+       const auto& p4=p._p4;
+       int geantCode = TDatabasePDG::Instance()->ConvertPdgToGeant3(p._pdg);
+       int charge = TDatabasePDG::Instance()->GetParticle(p._pdg)->Charge()/3;
        _stream<<_id++<<" "<<geantCode<<" "<<p4.M()<<"\n"
 	      <<"\t"<< charge <<" "<<p4.X()<<" "<<p4.Y()<<" "<<p4.Z()<<" "<<p4.T()<<"\n";
      }
    
      //data members
-     std::ofstream _file; //! output file
-     //std::ostream _stream; //! output stream
-     std::stringstream _stream;
-     std::string _filename;
      
      long _nEvent={0};
      int _nFile={1};
@@ -72,8 +68,8 @@ namespace elSpectro{
      int _beamPdg=0;
      int _targetPdg=0;
      
-     const Particle* _inBeam={nullptr};
-     const Particle* _inTarget={nullptr};
+     size_t _beamIndex={0}; //in EventRecord::Particles()
+     size_t _targetIndex={1};
      
      ClassDef(elSpectro::GlueXWriter,1); //class Writer
    };
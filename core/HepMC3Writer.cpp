@@ -1,22 +1,23 @@
 #include "HepMC3Writer.h"
 #include "Manager.h"
 #include <iostream>
+#include <algorithm>
 
 namespace elSpectro{
 
   ///Constructor to create ouput file and intialise data structures
   HepMC3Writer::HepMC3Writer(const std::string &filename):
-    _file(filename)
+    Writer{filename}
   {
-    if(!_file.is_open()){
-      std::cerr<<"HepMC3Writer::HepMC3Writer file "<<filename<<" cannot be opened, exiting..."<<std::endl;
-      exit(0);
-    }
+    WriteHeader();
+    Write();
+
+  }
+  ///////////////////////////////////////////////////////////////
+  void HepMC3Writer::WriteHeader(){
     //Give version used when this code was written
     _stream << "HepMC::Version 3.02.02"  << std::endl;
     _stream << "HepMC::Asciiv3-START_EVENT_LISTING" << std::endl;
-    Write();
-
   }
   HepMC3Writer::~HepMC3Writer(){
     End();
@@ -29,44 +30,35 @@ namespace elSpectro{
     Write();
     _file.close();
 
-  }
-  void HepMC3Writer::Init(){
-    Writer::Init();
-    //also
-    //need to find detached vertices
-    auto& unptrs=Manager::Instance().Particles().UnstableParticles();
-    for(const auto* p:unptrs){
-      //in case we have a detached vertex we need to write this particle
-      if(p->IsDecay()==DecayType::Detached)_vertexParticles.push_back(p);
-    }
-
   }
   /////////////////////////////////////////////////////////////
   //write all the info required for this event
-  void HepMC3Writer::FillAnEvent(){
+  void HepMC3Writer::FillAnEvent(const EventRecord& event){
 
     
     
     ////fill _stream
-    StreamEventInfo();
+    StreamEventInfo(event);
     StreamEventPosition();
     StreamUnits();
-    StreamWeights();
+    StreamWeights(event);
   
     _id=1;//reset particle ID counter
     //initial particles
-    auto nVer = _vertices->size();//last stored vertice = primary
+    auto nVer = event.Vertices().size();//last stored vertice = primary
     int initial_status=3;
     int initial_vertex_id=-1;
 
-     for(const auto* p:_initialParticles)
-      StreamParticle(p,initial_vertex_id,initial_status);
+    const auto& particles=event.Particles();
+    for(const auto& p:particles)
+      if(p._status==RecordStatus::Initial)
+	StreamParticle(p,initial_vertex_id,initial_status);
   
     //primary reaction vertex
     int primary_vertex_id=0;
     int primary_vertex_status=0;
     std::vector<int> primary_parent_ids={1,2};
-    StreamVertex(primary_vertex_id,primary_vertex_status,primary_parent_ids);
+    StreamVertex(event,primary_vertex_id,primary_vertex_status,primary_parent_ids);
   
     //final particles
     int final_status=1;
@@ -77,18 +69,18 @@ namespace elSpectro{
       int final_vertex_status=0;
 
       //first stream vertex decaying particles
-      for(const auto* p:_vertexParticles){
-	if(p->VertexID()==iver){
+      for(const auto& p:particles){
+	if(p._status==RecordStatus::Detached&&p._vertex==iver){
 	  int decay_particle_status=3;
 	  //save decay vertex ID and this particle id
-	  writtenVertexParticles.push_back(std::pair<int,int>(p->DecayVertexID(),_id));//before _id incremened
+	  writtenVertexParticles.push_back(std::pair<int,int>(p._decayVertex,_id));//before _id incremened
 	  StreamParticle(p,final_vertex_id, decay_particle_status);
 	}
       }
       bool first = (final_vertex_id != 0) ;//true if not production vertex
-      for(const auto* p:_finalParticles){
+      for(const auto& p:particles){
 	
-	if(p->VertexID()==iver){ //is this particle from this vertex?
+	if(p._status==RecordStatus::Final&&p._vertex==iver){ //is this particle from this vertex?
 	  
 	  //write vertex info first time there is a particle
 	  if(first==true){//see if need to write other vertex
@@ -103,7 +95,7 @@ namespace elSpectro{
 	    };
 	    auto decayParticleID=findVertex();
 	    
-	    StreamVertex(final_vertex_id,final_vertex_status,{decayParticleID});
+	    StreamVertex(event,final_vertex_id,final_vertex_status,{decayParticleID});
 	    first=false;
 	  }
 
@@ -117,14 +109,37 @@ namespace elSpectro{
 
   /////////////////////////////////////////////////////////
  
+
   /////////////////////////////////////////////////////////
-  void HepMC3Writer::Write(){
-    //write stream
-    _file<<_stream.rdbuf();
-    //reset stream
-    _stream.clear();
-  }
+  ///Single header and footer for all shards and renumber the events
+  void HepMC3Writer::MergeShards(const std::vector<std::string>& shards,
+				 const std::string& merged) const{
+    std::ofstream out(merged);
+    if(!out.is_open()){
+      std::cerr<<"HepMC3Writer::MergeShards file "<<merged<<" cannot be opened, exiting..."<<std::endl;
+      exit(0);
+    }
+    out << "HepMC::Version 3.02.02"  << std::endl;
+    out << "HepMC::Asciiv3-START_EVENT_LISTING" << std::endl;
 
+    long nEvent=0;
+    std::string line;
+    for(const auto& shard:shards){
+      std::ifstream in(shard);
+      while(std::getline(in,line)){
+	if(line.empty()) continue;
+	if(line.rfind("HepMC::",0)==0) continue; //shard header/footer
+	if(line.rfind("E ",0)==0){
+	  //replace shard event number with merged one
+	  auto afterNumber=std::min(line.find(' ',2),line.size());
+	  out<<"E "<<nEvent++<<line.substr(afterNumber)<<"\n";
+	  continue;
+	}
+	out<<line<<"\n";
+      }
+    }
+    out << "HepMC::Asciiv3-END_EVENT_LISTING" << std::endl << std::endl;
+  }
   /////////////////////////////////////////////////////////
   void HepMC3Writer::StreamEventPosition(){
     //from HepMC3::WriterAscii
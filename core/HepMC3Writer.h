@@ -31,22 +31,23 @@ namespace elSpectro{
      HepMC3Writer& operator=(const HepMC3Writer& other);
      HepMC3Writer& operator=(HepMC3Writer&& other) = default;
      
-     void WriteHeader() final{};
-     void FillAnEvent() final;
-     void Write() final;
+     void WriteHeader() final;
+     using Writer::FillAnEvent;
+     void FillAnEvent(const EventRecord& event) final;
      void End() final;
      
-     void Init() final;
+     
+     void MergeShards(const std::vector<std::string>& shards,
+		      const std::string& merged) const final;
      
    private:
-     decaying_constptrs _vertexParticles;
  
      //streaming functions
      
-     void StreamEventInfo(){
-       //E = event number, # vertices, # particles = initial+final
-       _stream<< "E"<<" "<<_nEvent<<" "<<_vertices->size()<<
-	 " "<<_initialParticles.size()+_finalParticles.size()+_vertexParticles.size()<<"\n";
+     void StreamEventInfo(const EventRecord& event){
+       //E = event number, # vertices, # particles = initial+final+detached
+       _stream<< "E"<<" "<<_nEvent<<" "<<event.Vertices().size()<<
+	 " "<<event.Particles().size()-event.NParticles(RecordStatus::Decayed)<<"\n";
      }
      /////////////////////////////////////////////////////////
      void StreamEventPosition();
@@ -54,19 +55,21 @@ namespace elSpectro{
      void StreamUnits(){
        _stream<< "U GEV MM"<<"\n";
      }
-     void StreamWeights(){}
+     void StreamWeights(const EventRecord& event){
+       _stream<< "W "<<event.Weight()<<"\n";
+     }
      void StreamAttributes(){
        /*_stream<< "A 0 Q2 "<<"\n";
       _stream<< "A 0 W "<<"\n";
        */
      }
-     void StreamParticle(const Particle* p,int vertex_id,int status){
-       auto p4=p->P4();
-       _stream<<"P "<<_id++<<" "<<-(vertex_id+1)<<" "<<p->Pdg()<<" "
+     void StreamParticle(const RecordParticle& p,int vertex_id,int status){
+       const auto& p4=p._p4;
+       _stream<<"P "<<_id++<<" "<<-(vertex_id+1)<<" "<<p._pdg<<" "
 	      <<p4.X()<<" "<<p4.Y()<<" "<<p4.Z()<<" "<<p4.T()
-	      <<" "<<p->Mass()<<" "<<status<<"\n";
+	      <<" "<<p._mass<<" "<<status<<"\n";
      }
-     void StreamVertex(int vertex_id,int status,std::vector<int> in_pids){
+     void StreamVertex(const EventRecord& event,int vertex_id,int status,std::vector<int> in_pids){
        _stream<<"V "<<-(vertex_id+1)<<" "<<status<<" [";
 
        uint ip=0;
@@ -81,18 +84,15 @@ namespace elSpectro{
        if(in_pids.empty())
 	 _stream<<"]";
        
-       const auto pos=_vertices->at(vertex_id);
-       //if(pos->M()!=0){
-	 _stream<<" @ "<<pos->X()<<" "<<pos->Y()<<" "
-		<<pos->Z()<<" "<<pos->T();
+       const auto& pos=event.Vertices().at(vertex_id);
+       //if(pos.M()!=0){
+	 _stream<<" @ "<<pos.X()<<" "<<pos.Y()<<" "
+		<<pos.Z()<<" "<<pos.T();
 	 // }
        _stream<<"\n";
      }
      
      //data members
-     std::ofstream _file; //! output file
-     //std::ostream _stream; //! output stream
-     std::stringstream _stream;
 
      long _nEvent={0};
    
@@ -0,0 +1,126 @@
+#include "InitCache.h"
+#include <TFile.h>
+#include <TMD5.h>
+#include <TSystem.h>
+#include <TVectorD.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace elSpectro{
+
+  namespace{
+    constexpr const char* CacheObjectName="elSpectroInitCache";
+  }
+
+  ///////////////////////////////////////////////////////////
+  void InitCache::SetDirectory(const std::string& dir){
+    _directory=dir;
+    if(_directory.empty()) return;
+    if(gSystem->AccessPathName(_directory.data())) //true if it does not exist
+      gSystem->mkdir(_directory.data(),kTRUE);
+  }
+  ///////////////////////////////////////////////////////////
+  void InitCache::SetConfigurationFile(const std::string& filename,const std::string& invocation){
+    std::ifstream in(filename);
+    if(!in.is_open()){
+      std::cerr<<"InitCache::SetConfigurationFile file "<<filename<<" cannot be opened, exiting..."<<std::endl;
+      exit(0);
+    }
+    std::stringstream config;
+    config<<in.rdbuf();
+    if(invocation.empty()==false) config<<'\n'<<invocation;
+    _configuration=config.str();
+  }
+  ///////////////////////////////////////////////////////////
+  ///Numbers are printed to full precision so any change
+  ///gives a different key
+  std::string InitCache::FileName(const std::string& name,const context_t& context) const{
+    std::ostringstream key;
+    key.precision(17);
+    key<<_configuration<<'\n'<<name;
+    for(auto val:context) key<<' '<<val;
+    auto text=key.str();
+
+    TMD5 md5;
+    md5.Update(reinterpret_cast<const UChar_t*>(text.data()),text.size());
+    md5.Final();
+    return _directory+"/"+md5.AsString()+".root";
+  }
+  ///////////////////////////////////////////////////////////
+  ///Write to a temporary file then rename, so other jobs
+  ///never read a partly written file
+  void InitCache::Save(const std::string& filename,TObject& obj) const{
+    auto tmpname=filename+Form(".%d.tmp",gSystem->GetPid());
+    {
+      std::unique_ptr<TFile> file{TFile::Open(tmpname.data(),"recreate")};
+      if(file.get()==nullptr || file->IsZombie()){
+	std::cerr<<"InitCache::Save cannot write "<<tmpname<<", not caching"<<std::endl;
+	return;
+      }
+      file->WriteTObject(&obj,CacheObjectName);
+    }
+    gSystem->Rename(tmpname.data(),filename.data());
+  }
+  ///////////////////////////////////////////////////////////
+  bool InitCache::Get(const std::string& name,const context_t& context,double& val) const{
+    if(Enabled()==false) return false;
+    auto filename=FileName(name,context);
+    if(gSystem->AccessPathName(filename.data())) return false;
+
+    std::unique_ptr<TFile> file{TFile::Open(filename.data())};
+    if(file.get()==nullptr || file->IsZombie()) return false;
+    auto vec=dynamic_cast<TVectorD*>(file->Get(CacheObjectName));
+    if(vec==nullptr || vec->GetNrows()!=1) return false;
+    val=(*vec)[0];
+    std::cout<<"InitCache::Get "<<name<<" = "<<val<<" from "<<filename<<std::endl;
+    return true;
+  }
+  ///////////////////////////////////////////////////////////
+  template<typename H>
+  bool InitCache::GetHist(const std::string& name,const context_t& context,H& hist) const{
+    if(Enabled()==false) return false;
+    auto filename=FileName(name,context);
+    if(gSystem->AccessPathName(filename.data())) return false;
+
+    std::unique_ptr<TFile> file{TFile::Open(filename.data())};
+    if(file.get()==nullptr || file->IsZombie()) return false;
+    auto cached=dynamic_cast<H*>(file->Get(CacheObjectName));
+    if(cached==nullptr) return false;
+    TString histname=hist.GetName();
+    hist=*cached;
+    hist.SetName(histname);
+    hist.SetDirectory(nullptr);
+    std::cout<<"InitCache::Get histogram "<<name<<" from "<<filename<<std::endl;
+    return true;
+  }
+  bool InitCache::Get(const std::string& name,const context_t& context,TH1D& hist) const{
+    return GetHist(name,context,hist);
+  }
+  bool InitCache::Get(const std::string& name,const context_t& context,TH2D& hist) const{
+    return GetHist(name,context,hist);
+  }
+  ///////////////////////////////////////////////////////////
+  void InitCache::Put(const std::string& name,const context_t& context,double val) const{
+    if(Enabled()==false) return;
+    TVectorD vec(1);
+    vec[0]=val;
+    Save(FileName(name,context),vec);
+  }
+  ///////////////////////////////////////////////////////////
+  template<typename H>
+  void InitCache::PutHist(const std::string& name,const context_t& context,const H& hist) const{
+    if(Enabled()==false) return;
+    H copy(hist);
+    copy.SetDirectory(nullptr);
+    Save(FileName(name,context),copy);
+  }
+  void InitCache::Put(const std::string& name,const context_t& context,const TH1D& hist) const{
+    PutHist(name,context,hist);
+  }
+  void InitCache::Put(const std::string& name,const context_t& context,const TH2D& hist) const{
+    PutHist(name,context,hist);
+  }
+
+}
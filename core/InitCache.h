@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		InitCache
+///Description:
+///             Store results of slow initialisation steps (integrals,
+///             maxima, envelopes) in ROOT files so identical jobs
+///             can load them instead of recalculating.
+///             Each result is keyed by an MD5 of
+///             1) the configuration, e.g. the text of the macro,
+///                covering model parameters the result depends on
+///             2) the name of the result
+///             3) the numbers the calculation used (masses, limits...)
+///             and written to its own file <directory>/<key>.root
+///             Disabled until both directory and configuration are set
+///             e.g. elspectro --cache /scratch/cache macro.C
+///             or in a macro
+///             generator().Cache().SetDirectory("cache");
+///             generator().Cache().SetConfigurationFile(__FILE__);
+#pragma once
+
+#include <TH1D.h>
+#include <TH2D.h>
+#include <string>
+#include <vector>
+
+namespace elSpectro{
+
+  class InitCache{
+
+  public:
+
+    using context_t = std::vector<double>;
+
+    void SetDirectory(const std::string& dir);
+    void SetConfiguration(const std::string& config){_configuration=config;}
+    //configuration is the contents of this file and the invocation,
+    //e.g. macro.C("arg",1), so different arguments give different keys
+    void SetConfigurationFile(const std::string& filename,const std::string& invocation="");
+
+    bool Enabled()const noexcept{
+      return _directory.empty()==false && _configuration.empty()==false;
+    }
+
+    //true if found, val or hist then hold the cached result
+    bool Get(const std::string& name,const context_t& context,double& val) const;
+    bool Get(const std::string& name,const context_t& context,TH1D& hist) const;
+    bool Get(const std::string& name,const context_t& context,TH2D& hist) const;
+    void Put(const std::string& name,const context_t& context,double val) const;
+    void Put(const std::string& name,const context_t& context,const TH1D& hist) const;
+    void Put(const std::string& name,const context_t& context,const TH2D& hist) const;
+
+  private:
+
+    std::string FileName(const std::string& name,const context_t& context) const;
+    void Save(const std::string& filename,TObject& obj) const;
+    template<typename H> bool GetHist(const std::string& name,const context_t& context,H& hist) const;
+    template<typename H> void PutHist(const std::string& name,const context_t& context,const H& hist) const;
+
+    std::string _directory;
+    std::string _configuration;//!
+
+  };
+
+}//namespace elSpectro
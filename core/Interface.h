@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Manager.h"
+#include "GeneratorContext.h"
 #include "DecayModelQ2W.h"
 #include "DecayModelW.h"
 #include "Distribution.h"
@@ -35,6 +36,17 @@ namespace elSpectro{
     generator().Write();
   }
   //////////////////////////////////////////////////////////////
+  //generate, write and count up to n events in one call
+  inline const EventBlock& generateBatch(size_t n){
+    return generator().GenerateBatch(n);
+  }
+  //////////////////////////////////////////////////////////////
+  //raise envelopes when exceeded and weight events to correct
+  inline void adaptive_envelopes(bool use=true){generator().SetAdaptiveEnvelopes(use);}
+  //////////////////////////////////////////////////////////////
+  //keep all proposed events, weighted by their accept/reject ratios
+  inline void weighted_events(bool use=true){generator().SetWeightedEvents(use);}
+  //////////////////////////////////////////////////////////////
   inline ParticleManager& particles(){return generator().Particles();}
   
   //////////////////////////////////////////////////////////////
@@ -0,0 +1,287 @@
+#include "InterpolationGrid.h"
+#include "FunctionsForThreads.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace elSpectro{
+
+  ///////////////////////////////////////////////////////////
+  InterpolationGrid::InterpolationGrid(const std::vector<double>& lower,const std::vector<double>& upper,
+				       const std::vector<int>& npoints,int nvalues):
+    _lower{lower},
+    _upper{upper},
+    _npoints{npoints},
+    _ndim(lower.size()),
+    _nvalues{nvalues}
+  {
+    if(_upper.size()!=_lower.size() || _npoints.size()!=_lower.size() || _ndim==0 || _nvalues<1){
+      std::cerr<<"InterpolationGrid::InterpolationGrid need lower, upper and number of points in each dimension, exiting..."<<std::endl;
+      exit(0);
+    }
+    _nNodes=1;
+    for(int id=0;id<_ndim;++id){
+      if(_npoints[id]<1 || _upper[id]<_lower[id]){
+	std::cerr<<"InterpolationGrid::InterpolationGrid bad range or number of points in dimension "<<id<<", exiting..."<<std::endl;
+	exit(0);
+      }
+      _step.push_back(_npoints[id]>1 ? (_upper[id]-_lower[id])/(_npoints[id]-1) : 0);
+      _stride.push_back(_nNodes);
+      _nNodes*=_npoints[id];
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  void InterpolationGrid::Fill(fill_t f,bool concurrent){
+    _values.assign(_nNodes*_nvalues,0);
+    threads::parallelFor(_nNodes,[&](int inode){
+	std::vector<double> x(_ndim);
+	Node(inode,x.data());
+	f(x.data(),&_values[inode*_nvalues]);
+      },concurrent);
+  }
+  ///////////////////////////////////////////////////////////
+  void InterpolationGrid::Node(size_t inode,double* x) const{
+    for(int id=0;id<_ndim;++id){
+      x[id]=_lower[id]+(inode%_npoints[id])*_step[id];
+      inode/=_npoints[id];
+    }
+  }
+  namespace{
+    //cubic c[0]+c[1]t+c[2]t^2+c[3]t^3
+    using cubic_t = std::array<double,4>;
+    //interval [first,second]
+    using range_t = std::pair<double,double>;
+
+    //Catmull-Rom weights of nodes i-1,i,i+1,i+2
+    const std::array<cubic_t,4> catmullRom{{{0,-0.5,1,-0.5},{1,0,-2.5,1.5},{0,0.5,2,-1.5},{0,0,-0.5,0.5}}};
+
+    cubic_t add(const cubic_t& a,const cubic_t& b,double fb){
+      return {a[0]+fb*b[0],a[1]+fb*b[1],a[2]+fb*b[2],a[3]+fb*b[3]};
+    }
+    //exact range for t in [0,1], at the ends or where the derivative is 0
+    range_t cubicRange(const cubic_t& c){
+      auto eval=[&c](double t){return c[0]+t*(c[1]+t*(c[2]+t*c[3]));};
+      range_t r{std::min(eval(0),eval(1)),std::max(eval(0),eval(1))};
+      auto extend=[&r,&eval](double t){
+	if(t<=0 || t>=1) return;
+	r.first=std::min(r.first,eval(t));
+	r.second=std::max(r.second,eval(t));
+      };
+      double qa=3*c[3];
+      double qb=2*c[2];
+      double qc=c[1];
+      if(qa==0){
+	if(qb!=0) extend(-qc/qb);
+      }
+      else{
+	double disc=qb*qb-4*qa*qc;
+	if(disc>=0){
+	  extend((-qb+std::sqrt(disc))/(2*qa));
+	  extend((-qb-std::sqrt(disc))/(2*qa));
+	}
+      }
+      return r;
+    }
+    //weight ranges of the 4 slots for an inner, the first and the last cell
+    std::array<std::array<range_t,4>,3> makeSlotRanges(){
+      const auto& w=catmullRom;
+      const cubic_t zero{0,0,0,0};
+      std::array<std::array<cubic_t,4>,3> cubics{{
+	  w,
+	  {zero,add(w[1],w[0],3),add(w[2],w[0],-3),add(w[3],w[0],1)},
+	  {add(w[0],w[3],1),add(w[1],w[3],-3),add(w[2],w[3],3),zero}
+	}};
+      std::array<std::array<range_t,4>,3> ranges;
+      for(int ic=0;ic<3;++ic)
+	for(int is=0;is<4;++is)
+	  ranges[ic][is]=cubicRange(cubics[ic][is]);
+      return ranges;
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  ///The 4 nodes in dimension id for coordinate xd, their weights
+  ///(if w) and the ranges of their weights over the cell (if range)
+  ///At an edge the node outside the grid is the quadratic
+  ///extrapolation of the 3 inside it, so its weight is folded into theirs
+  void InterpolationGrid::Stencil(int id,double xd,std::array<size_t,4>& in,
+				  std::array<double,4>* w,std::array<range_t,4>* range) const{
+    static const auto slotRanges=makeSlotRanges();
+    const int np=_npoints[id];
+    if(np==1){
+      in={0,0,0,0};
+      if(w) *w={1,0,0,0};
+      if(range) *range={range_t{1,1},range_t{0,0},range_t{0,0},range_t{0,0}};
+      return;
+    }
+    double u=(xd-_lower[id])/_step[id];
+    int i=std::min(std::max(static_cast<int>(std::floor(u)),0),np-2);
+    double t=std::min(std::max(u-i,0.),1.);
+    if(np==2){//linear
+      in={0,0,1,0};
+      if(w) *w={0,1-t,t,0};
+      if(range) *range={range_t{0,0},range_t{0,1},range_t{0,1},range_t{0,0}};
+      return;
+    }
+    int cellType=0;
+    if(i==0){//v(-1)=3v(0)-3v(1)+v(2)
+      cellType=1;
+      in={0,0,1,2};
+    }
+    else if(i==np-2){//v(np)=3v(np-1)-3v(np-2)+v(np-3)
+      cellType=2;
+      in={static_cast<size_t>(i-1),static_cast<size_t>(i),static_cast<size_t>(i+1),0};
+    }
+    else
+      in={static_cast<size_t>(i-1),static_cast<size_t>(i),
+	  static_cast<size_t>(i+1),static_cast<size_t>(i+2)};
+    if(range) *range=slotRanges[cellType];
+    if(w){
+      double t2=t*t;
+      double t3=t2*t;
+      auto& ww=*w;
+      ww={0.5*(-t+2*t2-t3),0.5*(2-5*t2+3*t3),0.5*(t+4*t2-3*t3),0.5*(t3-t2)};
+      if(cellType==1) ww={0,ww[1]+3*ww[0],ww[2]-3*ww[0],ww[3]+ww[0]};
+      else if(cellType==2) ww={ww[0]+ww[3],ww[1]-3*ww[3],ww[2]+3*ww[3],0};
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  ///Each dimension gives 4 nodes and Catmull-Rom weights
+  void InterpolationGrid::Interpolate(const double* x,double* values,int first,int n) const{
+    if(n<0) n=_nvalues-first;
+    std::fill(values,values+n,0.);
+    if(Empty()) return;
+
+    std::vector<std::array<size_t,4>> nodes(_ndim);
+    std::vector<std::array<double,4>> weights(_ndim);
+    for(int id=0;id<_ndim;++id)
+      Stencil(id,x[id],nodes[id],&weights[id],nullptr);
+
+    //sum over the 4^ndim neighbouring nodes
+    std::vector<int> k(_ndim,0);
+    while(true){
+      double weight=1;
+      size_t inode=0;
+      for(int id=0;id<_ndim && weight!=0;++id){
+	weight*=weights[id][k[id]];
+	inode+=nodes[id][k[id]]*_stride[id];
+      }
+      if(weight!=0){
+	const double* nodeValues=&_values[inode*_nvalues+first];
+	for(int iv=0;iv<n;++iv) values[iv]+=weight*nodeValues[iv];
+      }
+      int id=0;
+      for(;id<_ndim;++id){
+	if(++k[id]<4) break;
+	k[id]=0;
+      }
+      if(id==_ndim) break;
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  ///The weights W_k sum to 1, so for any c
+  ///Interpolate = c + sum_k W_k (v_k - c)
+  ///Each term is bounded with the range of W_k over the cell,
+  ///the product of the ranges of its weight in each dimension,
+  ///c is the average of the cell corners
+  void InterpolationGrid::InterpolatedBounds(const double* x,int iv,double& lower,double& upper) const{
+    lower=upper=0;
+    if(Empty()) return;
+
+    std::vector<std::array<size_t,4>> nodes(_ndim);
+    std::vector<std::array<range_t,4>> ranges(_ndim);
+    for(int id=0;id<_ndim;++id)
+      Stencil(id,x[id],nodes[id],nullptr,&ranges[id]);
+
+    //f(weight range,node value) over the 4^ndim stencil
+    auto forStencil=[&](auto f){
+      std::vector<int> k(_ndim,0);
+      while(true){
+	range_t W{1,1};
+	size_t inode=0;
+	for(int id=0;id<_ndim;++id){
+	  const auto& r=ranges[id][k[id]];
+	  auto p={W.first*r.first,W.first*r.second,W.second*r.first,W.second*r.second};
+	  W={std::min(p),std::max(p)};
+	  inode+=nodes[id][k[id]]*_stride[id];
+	}
+	if(W.first!=0 || W.second!=0) f(W,_values[inode*_nvalues+iv]);
+	int id=0;
+	for(;id<_ndim;++id){
+	  if(++k[id]<4) break;
+	  k[id]=0;
+	}
+	if(id==_ndim) break;
+      }
+    };
+
+    double c=0;
+    double sumW=0;
+    forStencil([&c,&sumW](const range_t& W,double v){
+	if(W.first>=0){//positive weight, the cell corners
+	  c+=v;
+	  sumW+=1;
+	}
+      });
+    if(sumW>0) c/=sumW;
+
+    lower=c;
+    upper=c;
+    forStencil([&lower,&upper,c](const range_t& W,double v){
+	auto d=v-c;
+	lower+=std::min(W.first*d,W.second*d);
+	upper+=std::max(W.first*d,W.second*d);
+      });
+  }
+  ///////////////////////////////////////////////////////////
+  void InterpolationGrid::CellBounds(const double* x,int iv,double& lower,double& upper) const{
+    lower=upper=0;
+    if(Empty()) return;
+
+    //neighbouring nodes first to last in each dimension, the cell is i,i+1
+    std::vector<int> first(_ndim);
+    std::vector<int> last(_ndim);
+    std::vector<int> cell(_ndim);
+    for(int id=0;id<_ndim;++id){
+      const int np=_npoints[id];
+      int i=0;
+      if(np>1)
+	i=std::min(std::max(static_cast<int>(std::floor((x[id]-_lower[id])/_step[id])),0),np-2);
+      cell[id]=i;
+      first[id]=std::max(i-1,0);
+      last[id]=std::min(i+2,np-1);
+    }
+
+    double cellMin=std::numeric_limits<double>::max();
+    double cellMax=std::numeric_limits<double>::lowest();
+    double nearMin=cellMin;
+    double nearMax=cellMax;
+    std::vector<int> k(first);
+    while(true){
+      size_t inode=0;
+      bool corner=true;
+      for(int id=0;id<_ndim;++id){
+	inode+=k[id]*_stride[id];
+	if(k[id]<cell[id] || k[id]>cell[id]+1) corner=false;
+      }
+      auto val=_values[inode*_nvalues+iv];
+      nearMin=std::min(nearMin,val);
+      nearMax=std::max(nearMax,val);
+      if(corner){
+	cellMin=std::min(cellMin,val);
+	cellMax=std::max(cellMax,val);
+      }
+      int id=0;
+      for(;id<_ndim;++id){
+	if(++k[id]<=last[id]) break;
+	k[id]=first[id];
+      }
+      if(id==_ndim) break;
+    }
+    auto margin=(nearMax-nearMin)/4;
+    lower=cellMin-margin;
+    upper=cellMax+margin;
+  }
+
+}
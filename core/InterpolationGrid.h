@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		InterpolationGrid
+///Description:
+///             Several functions of the same variables tabulated on
+///             a regular grid and interpolated with cubic Catmull-Rom
+///             splines, one dimension after the other
+///             Edges use a quadratic extrapolation for the missing
+///             node, 2 points is linear and 1 point is constant
+///             Fill() calls f once per node, shared between threads
+///             if concurrent
+///             e.g.
+///             InterpolationGrid grid({Wmin,-1},{Wmax,1},{200,100},2);
+///             grid.Fill([](const double* x,double* values){...});
+///             grid.Interpolate(x,values);
+#pragma once
+
+#include <array>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace elSpectro{
+
+  class InterpolationGrid{
+
+  public:
+
+    using fill_t = std::function<void(const double* x,double* values)>;
+
+    InterpolationGrid()=default;
+    InterpolationGrid(const std::vector<double>& lower,const std::vector<double>& upper,
+		      const std::vector<int>& npoints,int nvalues);
+
+    void Fill(fill_t f,bool concurrent=true);
+
+    bool Empty()const noexcept{return _values.empty();}
+    bool Inside(const double* x)const noexcept{
+      for(int id=0;id<_ndim;++id)
+	if(x[id]<_lower[id] || x[id]>_upper[id]) return false;
+      return true;
+    }
+    //values first to first+n-1, n<0 => all from first
+    void Interpolate(const double* x,double* values,int first=0,int n=-1) const;
+    //guaranteed bounds of Interpolate() for value iv over the cell
+    //containing x, from the ranges of the spline weights in the cell
+    void InterpolatedBounds(const double* x,int iv,double& lower,double& upper) const;
+    //range of value iv at the corners of the cell containing x, widened
+    //by a quarter of its range over the neighbouring cells for curvature
+    //an estimate for the tabulated function, not a guaranteed bound
+    void CellBounds(const double* x,int iv,double& lower,double& upper) const;
+
+    //coordinates of node inode, first dimension fastest
+    void Node(size_t inode,double* x) const;
+    size_t NNodes()const noexcept{return _nNodes;}
+    int NDim()const noexcept{return _ndim;}
+    int NValues()const noexcept{return _nvalues;}
+
+  private:
+
+    //nodes, weights and weight ranges in dimension id around xd
+    void Stencil(int id,double xd,std::array<size_t,4>& in,std::array<double,4>* w,
+		 std::array<std::pair<double,double>,4>* range) const;
+
+    std::vector<double> _lower;
+    std::vector<double> _upper;
+    std::vector<double> _step;
+    std::vector<int> _npoints;
+    std::vector<size_t> _stride;
+    std::vector<double> _values; //_nvalues per node
+    size_t _nNodes={0};
+    int _ndim={0};
+    int _nvalues={0};
+
+  };
+
+}//namespace elSpectro
@@ -0,0 +1,124 @@
+#include "InverseCDFTable.h"
+#include "FunctionsForSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace elSpectro{
+
+  ///////////////////////////////////////////////////////////
+  void InverseCDFTable::Build(const std::function<double(double)>& f,double xmin,double xmax,
+			      int ninit,double tolerance,size_t maxNodes){
+    if(!(xmax>xmin) || ninit<1){
+      std::cerr<<"InverseCDFTable::Build need xmax > xmin and at least 1 segment, exiting..."<<std::endl;
+      exit(1);
+    }
+    auto eval=[&f](double x){
+      auto val=f(x);
+      if(std::isfinite(val)==false){
+	std::cerr<<"InverseCDFTable::Build function is "<<val<<" at x = "<<x<<", restrict its range, exiting..."<<std::endl;
+	exit(1);
+      }
+      return val<0 ? 0. : val;
+    };
+
+    //coarse estimate of the total to set the scale of the tolerance
+    std::vector<double> xinit(ninit+1);
+    std::vector<double> finit(ninit+1);
+    double total=0;
+    for(int i=0;i<=ninit;++i){
+      xinit[i]=xmin+(xmax-xmin)*i/ninit;
+      finit[i]=eval(xinit[i]);
+      if(i>0) total+=(finit[i-1]+finit[i])/2*(xinit[i]-xinit[i-1]);
+    }
+    const double maxError= total>0 ? tolerance*total : tolerance;
+    const size_t maxSplits= maxNodes>static_cast<size_t>(ninit) ? maxNodes-ninit : 0;
+
+    _x.clear();
+    _f.clear();
+    _x.push_back(xinit[0]);
+    _f.push_back(finit[0]);
+
+    //depth first so nodes come out in order
+    struct Segment{double _a,_b,_fa,_fb;int _depth;};
+    std::vector<Segment> stack;
+    size_t nsplits=0;
+    for(int i=0;i<ninit;++i){
+      stack.push_back({xinit[i],xinit[i+1],finit[i],finit[i+1],0});
+      while(stack.empty()==false){
+	auto seg=stack.back();
+	stack.pop_back();
+	double m=(seg._a+seg._b)/2;
+	double fm=eval(m);
+	double width=seg._b-seg._a;
+	double trapezoid=(seg._fa+seg._fb)/2*width;
+	double simpson=(seg._fa+4*fm+seg._fb)/6*width;
+	if(std::abs(trapezoid-simpson)>maxError && seg._depth<30 && nsplits<maxSplits){
+	  ++nsplits;
+	  stack.push_back({m,seg._b,fm,seg._fb,seg._depth+1});
+	  stack.push_back({seg._a,m,seg._fa,fm,seg._depth+1});
+	  continue;
+	}
+	_x.push_back(seg._b);
+	_f.push_back(seg._fb);
+      }
+    }
+
+    _cdf.resize(_x.size());
+    _cdf[0]=0;
+    for(size_t i=1;i<_x.size();++i)
+      _cdf[i]=_cdf[i-1]+(_f[i-1]+_f[i])/2*(_x[i]-_x[i-1]);
+
+    if(Integral()<=0){
+      std::cerr<<"InverseCDFTable::Build function has no positive values in range "<<xmin<<" - "<<xmax<<", exiting..."<<std::endl;
+      exit(1);
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  size_t InverseCDFTable::FindSegment(double x) const noexcept{
+    size_t is=std::upper_bound(_x.begin(),_x.end(),x)-_x.begin();
+    return std::min(is>0 ? is-1 : 0,_x.size()-2);
+  }
+  ///////////////////////////////////////////////////////////
+  double InverseCDFTable::CDF(double x) const noexcept{
+    if(x<=_x.front()) return 0;
+    if(x>=_x.back()) return _cdf.back();
+    auto is=FindSegment(x);
+    auto width=_x[is+1]-_x[is];
+    auto t=(x-_x[is])/width;
+    return _cdf[is] + width*t*(_f[is] + (_f[is+1]-_f[is])*t/2);
+  }
+  ///////////////////////////////////////////////////////////
+  double InverseCDFTable::Invert(size_t is,double area) const noexcept{
+    auto segArea=_cdf[is+1]-_cdf[is];
+    auto frac= segArea>0 ? std::min(std::max(area/segArea,0.),1.) : 0.5;
+    auto t=sampling::linearFraction(_f[is],_f[is+1],frac);
+    return _x[is]+t*(_x[is+1]-_x[is]);
+  }
+  ///////////////////////////////////////////////////////////
+  double InverseCDFTable::Sample(double u) const noexcept{
+    auto target=u*_cdf.back();
+    size_t is=std::upper_bound(_cdf.begin(),_cdf.end(),target)-_cdf.begin();
+    is=std::min(is>0 ? is-1 : 0,_x.size()-2);
+    return Invert(is,target-_cdf[is]);
+  }
+  ///////////////////////////////////////////////////////////
+  ///limits outside of the table are moved to its edges,
+  ///if there is no weight between them x is uniform
+  double InverseCDFTable::Sample(double xmin,double xmax,double u) const noexcept{
+    xmin=std::max(xmin,_x.front());
+    xmax=std::min(xmax,_x.back());
+    if(xmax<=xmin) return xmin;
+    auto cdfmin=CDF(xmin);
+    auto cdfmax=CDF(xmax);
+    if(cdfmax<=cdfmin) return xmin+u*(xmax-xmin);
+
+    auto target=cdfmin+u*(cdfmax-cdfmin);
+    size_t is=std::upper_bound(_cdf.begin(),_cdf.end(),target)-_cdf.begin();
+    is=std::min(is>0 ? is-1 : 0,_x.size()-2);
+    auto x=Invert(is,target-_cdf[is]);
+    //rounding at the limits
+    return std::min(std::max(x,xmin),xmax);
+  }
+
+}
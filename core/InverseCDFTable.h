@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		InverseCDFTable
+///Description:
+///             Cumulative integral of a 1D density on nodes which are
+///             refined where the density is not linear, so narrow
+///             peaks are resolved. The density is taken as linear
+///             between nodes, so the CDF can be inverted exactly
+///             in each segment. Draws from any sub range [xmin,xmax]
+///             invert between CDF(xmin) and CDF(xmax) with a binary
+///             search, nothing is recalculated
+///             e.g.
+///             InverseCDFTable table;
+///             table.Build([&f](double x){return f.Eval(x);},0,10);
+///             auto x = table.Sample(2,5,rng().Uniform());
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace elSpectro{
+
+  class InverseCDFTable{
+
+  public:
+
+    //negative values of f are taken as 0, nan or inf are an error
+    //segments are halved until trapezoid and Simpson integrals
+    //agree to tolerance*total, up to maxNodes
+    void Build(const std::function<double(double)>& f,double xmin,double xmax,
+	       int ninit=1000,double tolerance=1E-6,size_t maxNodes=200000);
+
+    //integral from the low edge of the table to x
+    double CDF(double x) const noexcept;
+    double Integral() const noexcept{return _cdf.empty() ? 0 : _cdf.back();}
+
+    //u uniform on (0,1)
+    double Sample(double u) const noexcept;
+    double Sample(double xmin,double xmax,double u) const noexcept;
+
+    double GetMinX()const noexcept{return _x.front();}
+    double GetMaxX()const noexcept{return _x.back();}
+    size_t NNodes()const noexcept{return _x.size();}
+    bool Empty()const noexcept{return _x.empty();}
+
+  private:
+
+    size_t FindSegment(double x) const noexcept;
+    //x where the integral from node is reaches area
+    double Invert(size_t is,double area) const noexcept;
+
+    std::vector<double> _x;
+    std::vector<double> _f;
+    std::vector<double> _cdf;
+
+  };
+
+}//namespace elSpectro
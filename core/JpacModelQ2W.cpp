@@ -15,7 +15,7 @@ namespace elSpectro{
     // ->   DecayModel{{ new DecayingParticle{-2211,Decay_st} },{11}}
   {
     _name={"JpacModelQ2W"};
-
+    UseQ2Envelope(false); //has its own W envelope
    
   }
   ///////////////////////////////////////////////////////
@@ -30,6 +30,7 @@ namespace elSpectro{
     // ->   DecayModel{{ new DecayingParticle{-2211,Decay_st} },{11}}
   {
     _name={"JpacModelQ2W_given_s_and_t"};
+    UseQ2Envelope(false); //has its own W envelope
   }
 
   ////////////////////////////////////////////////////////
@@ -49,16 +50,25 @@ namespace elSpectro{
     auto prodInfo=ProdInfo();
     double maxW = ( *(prodInfo->_target) + *(prodInfo->_ebeam) ).M();
 
-    std::cout<<"JpacModelQ2W::PostInit generating total cross section, may take some time... "<<std::endl;
-    TH1D histlow("Wdistlow","Wdistlow",50,0,maxW);
-    _amp->kinematics->set_vectormass(GetDecayMeson()->MinimumMassPossible());//to get threshold behaviour
-    jpacFun::HistProbabilityDistribution_s(_amp,histlow);
+    auto& cache=generator().Cache();
+    InitCache::context_t context{maxW,prodInfo->_target->M(),
+	GetDecayMeson()->MinimumMassPossible(),GetDecayMeson()->PdgMass()};
+    TH1D hist("WdistEnvelope","WdistEnvelope",50,0,maxW);
+    if(cache.Get("JpacModelQ2W::Wdist",context,hist)==false){
+      std::cout<<"JpacModelQ2W::PostInit generating total cross section, may take some time... "<<std::endl;
+      TH1D histlow("Wdistlow","Wdistlow",50,0,maxW);
+      _amp->kinematics->set_vectormass(GetDecayMeson()->MinimumMassPossible());//to get threshold behaviour
+      jpacFun::HistProbabilityDistribution_s(_amp,histlow);
 
-    TH1D histpeak("Wdist","Wdist",50,0,maxW);
-    _amp->kinematics->set_vectormass(GetDecayMeson()->PdgMass());//to get threshold behaviour
-    jpacFun::HistProbabilityDistribution_s(_amp,histpeak);
+      TH1D histpeak("Wdist","Wdist",50,0,maxW);
+      _amp->kinematics->set_vectormass(GetDecayMeson()->PdgMass());//to get threshold behaviour
+      jpacFun::HistProbabilityDistribution_s(_amp,histpeak);
     
-    auto hist = jpacFun::HistFromLargestBins(histlow,histpeak);
+      hist = jpacFun::HistFromLargestBins(histlow,histpeak);
+      cache.Put("JpacModelQ2W::Wdist",context,hist);
+    }
+    else
+      _amp->kinematics->set_vectormass(GetDecayMeson()->PdgMass());//as if calculated
     
     //    auto maxVal= hist.GetMaximum();
    
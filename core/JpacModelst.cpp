@@ -2,8 +2,18 @@
 #include "FunctionsForJpac.h"
 #include "FunctionsForGenvector.h"
 #include <TDatabasePDG.h>
+#include <map>
 
 namespace elSpectro{
+
+  ///factory amplitudes borrowed by this thread, given back
+  ///to their models when it ends so the next scan reuses them
+  struct JpacBorrowedAmps{
+    std::map<const JpacModelst*,jpacAmp_ptr> _amps;
+    ~JpacBorrowedAmps(){
+      for(auto& borrowed:_amps) borrowed.first->ReturnAmp(borrowed.second);
+    }
+  };
   ///////////////////////////////////////////////////////
   ///constructor includes subseqent decay of Ngamma* system
   JpacModelst::JpacModelst( jpacPhoto::amplitude* amp ,
@@ -17,6 +27,37 @@ namespace elSpectro{
     std::cout<<"JpacModelst::JpacModelst "<<_amp<<std::endl;
   }
   /////////////////////////////////////////////////////////////////
+  jpacAmp_ptr JpacModelst::Amp() const{
+    if(!_ampFactory || std::this_thread::get_id()==_ampThread) return _amp;
+    thread_local JpacBorrowedAmps borrowed;
+    auto& amp=borrowed._amps[this];
+    if(amp==nullptr) amp=BorrowAmp();
+    return amp;
+  }
+  /////////////////////////////////////////////////////////////////
+  ///At most one factory amplitude per thread that ever ran concurrently
+  jpacAmp_ptr JpacModelst::BorrowAmp() const{
+    {
+      std::lock_guard<std::mutex> lock(_ampMutex);
+      if(_freeAmps.empty()==false){
+	auto amp=_freeAmps.back();
+	_freeAmps.pop_back();
+	return amp;
+      }
+    }
+    auto amp=_ampFactory();
+    if(amp==nullptr){
+      std::cerr<<"JpacModelst::BorrowAmp amplitude factory returned nullptr, exiting..."<<std::endl;
+      exit(1);
+    }
+    return amp;
+  }
+  /////////////////////////////////////////////////////////////////
+  void JpacModelst::ReturnAmp(jpacAmp_ptr amp) const{
+    std::lock_guard<std::mutex> lock(_ampMutex);
+    _freeAmps.push_back(amp);
+  }
+  /////////////////////////////////////////////////////////////////
   /*void JpacModelst::PostInit(ReactionInfo* info){
 
     DecayModelst::PostInit(info);
@@ -28,55 +69,75 @@ namespace elSpectro{
     std::cout<<"JpacModelst::PostInit max value "<<" "<<_meson<<" "<<_meson->Pdg()<<" "<<_sdmeMeson<<std::endl;
     }*/
   //////////////////////////////////////////////////////////////////
+  ///All elements at this s and t together. The amplitude caches its
+  ///helicity amplitudes, so they are calculated once for the meson
+  ///mass and shared by every element, and each distinct element is
+  ///only requested once
   void JpacModelst::CalcMesonSDMEs() const {
     //Meson spin density marix elements, note this is photoproduced
     auto *sdme=GetMesonSDMEs();
+    if(sdme==nullptr) return;
+
+    const auto s=get_s();
+    const auto t=get_t();
+    auto amp=Amp();
+    amp->_kinematics->set_mX( GetMeson()->Mass() );
+    amp->check_cache(s,t);
+    auto rho=[amp,s,t](int alpha,int lam,int lamp){
+      return amp->SDME(alpha,lam,lamp,s,t);
+    };
     
-    if(sdme){ //note this is vector formalism
-      if(sdme->Spin()==1){
-	sdme->SetElement(0,0,0,(_amp->SDME(0, 0, 0, get_s(), get_t())));
-	sdme->SetElement(0,1,0,(_amp->SDME(0, 1, 0, get_s(), get_t())));
-	sdme->SetElement(0,1,-1,(_amp->SDME(0, 1, -1, get_s(), get_t())));
-	sdme->SetElement(1,1,1,(_amp->SDME(1, 1, 1, get_s(), get_t())));
-	sdme->SetElement(1,0,0,(_amp->SDME(1, 0, 0, get_s(), get_t())));
-	sdme->SetElement(1,1,0,(_amp->SDME(1, 1, 0, get_s(), get_t())));
-	sdme->SetElement(1,1,-1,(_amp->SDME(1, 1, -1, get_s(), get_t())));
-	sdme->SetElement(2,1,0,(_amp->SDME(2, 1, 0, get_s(), get_t())));
-	sdme->SetElement(2,1,-1,(_amp->SDME(2, 1, -1, get_s(), get_t())));
-      }
-      else if(sdme->Spin()==2){
-	sdme->SetElement(0,0,0,(_amp->SDME(0, 0, 0, get_s(), get_t())));
-	sdme->SetElement(0,1,0,(_amp->SDME(0, 1, 0, get_s(), get_t())));
-	sdme->SetElement(0,1,-1,(_amp->SDME(0, 1, -1, get_s(), get_t())));
-	sdme->SetElement(0,1,1,(_amp->SDME(0, 1, 1, get_s(), get_t())));
-	sdme->SetElement(0,2,-2,(_amp->SDME(0, 2, -2, get_s(), get_t())));
-	sdme->SetElement(0,2,0,(_amp->SDME(0, 2, 0, get_s(), get_t())));
-	sdme->SetElement(0,2,1,(_amp->SDME(0, 2, 1, get_s(), get_t())));
-	sdme->SetElement(0,2,2,(_amp->SDME(0, 2, 2, get_s(), get_t())));
+    //note this is vector formalism
+    if(sdme->Spin()==1){
+      sdme->SetElement(0,0,0,rho(0, 0, 0));
+      sdme->SetElement(0,1,0,rho(0, 1, 0));
+      sdme->SetElement(0,1,-1,rho(0, 1, -1));
+      sdme->SetElement(1,1,1,rho(1, 1, 1));
+      sdme->SetElement(1,0,0,rho(1, 0, 0));
+      sdme->SetElement(1,1,0,rho(1, 1, 0));
+      sdme->SetElement(1,1,-1,rho(1, 1, -1));
+      sdme->SetElement(2,1,0,rho(2, 1, 0));
+      sdme->SetElement(2,1,-1,rho(2, 1, -1));
+    }
+    else if(sdme->Spin()==2){
+      //alpha=1,2 take the alpha=0 elements
+      const auto r00=rho(0, 0, 0);
+      const auto r10=rho(0, 1, 0);
+      const auto r1m1=rho(0, 1, -1);
+      const auto r11=rho(0, 1, 1);
+      const auto r2m2=rho(0, 2, -2);
+      const auto r2m1=rho(0, 2, -1);
+      const auto r20=rho(0, 2, 0);
+      const auto r21=rho(0, 2, 1);
+      const auto r22=rho(0, 2, 2);
+      
+      sdme->SetElement(0,0,0,r00);
+      sdme->SetElement(0,1,0,r10);
+      sdme->SetElement(0,1,-1,r1m1);
+      sdme->SetElement(0,1,1,r11);
+      sdme->SetElement(0,2,-2,r2m2);
+      sdme->SetElement(0,2,0,r20);
+      sdme->SetElement(0,2,1,r21);
+      sdme->SetElement(0,2,2,r22);
 	
-	sdme->SetElement(1,0,0,(_amp->SDME(0, 0, 0, get_s(), get_t())));
-	sdme->SetElement(1,1,0,(_amp->SDME(0, 1, 0, get_s(), get_t())));
-	sdme->SetElement(1,1,-1,(_amp->SDME(0, 1, -1, get_s(), get_t())));
-	sdme->SetElement(1,1,1,(_amp->SDME(0, 1, 1, get_s(), get_t())));
-	sdme->SetElement(1,2,-1,(_amp->SDME(0, 2, -1, get_s(), get_t())));
-	sdme->SetElement(1,2,-2,(_amp->SDME(0, 2, -2, get_s(), get_t())));
-	sdme->SetElement(1,2,0,(_amp->SDME(0, 2, 0, get_s(), get_t())));
-	sdme->SetElement(1,2,1,(_amp->SDME(0, 2, 1, get_s(), get_t())));
-	sdme->SetElement(1,2,2,(_amp->SDME(0, 2, 2, get_s(), get_t())));
-
-	sdme->SetElement(2,1,0,(_amp->SDME(0, 1, 0, get_s(), get_t())));
-	sdme->SetElement(2,1,-1,(_amp->SDME(0, 1, -1, get_s(), get_t())));
-	sdme->SetElement(2,2,-1,(_amp->SDME(0, 2, -1, get_s(), get_t())));
-	sdme->SetElement(2,2,-2,(_amp->SDME(0, 2, -2, get_s(), get_t())));
-	sdme->SetElement(2,2,0,(_amp->SDME(0, 2, 0, get_s(), get_t())));
-	sdme->SetElement(2,2,1,(_amp->SDME(0, 2, 1, get_s(), get_t())));
-
-
-
-      }
+      sdme->SetElement(1,0,0,r00);
+      sdme->SetElement(1,1,0,r10);
+      sdme->SetElement(1,1,-1,r1m1);
+      sdme->SetElement(1,1,1,r11);
+      sdme->SetElement(1,2,-1,r2m1);
+      sdme->SetElement(1,2,-2,r2m2);
+      sdme->SetElement(1,2,0,r20);
+      sdme->SetElement(1,2,1,r21);
+      sdme->SetElement(1,2,2,r22);
+
+      sdme->SetElement(2,1,0,r10);
+      sdme->SetElement(2,1,-1,r1m1);
+      sdme->SetElement(2,2,-1,r2m1);
+      sdme->SetElement(2,2,-2,r2m2);
+      sdme->SetElement(2,2,0,r20);
+      sdme->SetElement(2,2,1,r21);
     }
 
-
   }
   //////////////////////////////////////////////////////////////////
   void JpacModelst::CalcBaryonSDMEs() const {
@@ -9,16 +9,26 @@
 ///
 ///            Note derived classes should include a constructor to initialise
 ///            JpacModelst( particle_ptrs , const std::vector<int> pdgs );
+///
+///            jpacPhoto amplitudes keep the kinematics they were last
+///            called with, so scans run serially unless a factory gives
+///            each thread its own amplitude and reaction_kinematics
+///            SetAmplitudeFactory([]{return MakeMyAmplitude();});
 #pragma once
 
 #include "DecayModelst.h"
 #include "SDME.h"
 #include "FunctionsForElectronScattering.h"
 #include "amplitudes/amplitude.hpp"
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace elSpectro{
 
   using jpacAmp_ptr = jpacPhoto::amplitude*;
+  using jpacAmp_factory = std::function<jpacAmp_ptr()>;
 
   class JpacModelst : public DecayModelst {
 
@@ -34,19 +44,34 @@ namespace elSpectro{
 
 
     double MatrixElementsSquared_T() const override {
-      _amp->_kinematics->set_mX( GetMeson()->Mass() );
-     // _amp->_kinematics->set_Q2( get_Q2() );
-      //std::cout<<"me "<<GetMeson()->Mass()<<" Q2 "<< get_Q2()<<" t "<<get_t()<<" s "<<get_s()<<" W "<<get_W()<<" jpac "<<_amp->_kinematics->Wth()<<" VAL "<<_amp->probability_distribution(get_s(),get_t())/4<<std::endl;
-      if(get_W()<_amp->_kinematics->Wth()) return 0;
-      return _amp->probability_distribution(get_s(),get_t())/4;// Average over initial state helicites;
+      auto amp=Amp();
+      amp->_kinematics->set_mX( GetMeson()->Mass() );
+     // amp->_kinematics->set_Q2( get_Q2() );
+      //std::cout<<"me "<<GetMeson()->Mass()<<" Q2 "<< get_Q2()<<" t "<<get_t()<<" s "<<get_s()<<" W "<<get_W()<<" jpac "<<amp->_kinematics->Wth()<<" VAL "<<amp->probability_distribution(get_s(),get_t())/4<<std::endl;
+      if(get_W()<amp->_kinematics->Wth()) return 0;
+      return amp->probability_distribution(get_s(),get_t())/4;// Average over initial state helicites;
     }
+    //factory for copies of the amplitude, called from many threads
+    //at once, which I do not own either
+    void SetAmplitudeFactory(jpacAmp_factory factory){_ampFactory=factory;}
+    bool CanEvaluateConcurrently() const override {return bool(_ampFactory);}
     
     void CalcMesonSDMEs() const  override ;
     void CalcBaryonSDMEs() const   override ;
     
   private:
 
+    //_amp on the thread which constructed me, a factory copy on others
+    jpacAmp_ptr Amp() const;
+    jpacAmp_ptr BorrowAmp() const;
+    void ReturnAmp(jpacAmp_ptr amp) const;
+    friend struct JpacBorrowedAmps;
+
     jpacAmp_ptr _amp={nullptr}; //I am not the owner
+    jpacAmp_factory _ampFactory;//!
+    std::thread::id _ampThread={std::this_thread::get_id()};//!
+    mutable std::vector<jpacAmp_ptr> _freeAmps;//! factory copies not in use
+    mutable std::mutex _ampMutex;//!
 
     ClassDefOverride(elSpectro::JpacModelst,1); //class JpacModelst
     
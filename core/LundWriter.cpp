@@ -6,14 +6,9 @@ namespace elSpectro{
 
   ///Constructor to create ouput file and intialise data structures
   LundWriter::LundWriter(const std::string &filename,long evPerFile):
-    _filename(filename),
-    _file(filename),
+    Writer{filename},
     _eventsPerFile(evPerFile)
   {
-    if(!_file.is_open()){
-      std::cerr<<"LundWriter::LundWriter file "<<filename<<" cannot be opened, exiting..."<<std::endl;
-      exit(0);
-    }
  
   }
   
@@ -26,17 +21,18 @@ namespace elSpectro{
 
     Writer::Init();
     //need to find e- and baryon
+    //initial particles come first in EventRecord
     if(TDatabasePDG::Instance()->GetParticle(_initialParticles[0]->Pdg())->ParticleClass()==TString("Baryon") ){
-      _inTarget=_initialParticles[0];
-      _inBeam=_initialParticles[1]; 
+      _targetIndex=0;
+      _beamIndex=1; 
     }
     else {
-      _inTarget=_initialParticles[1];
-      _inBeam=_initialParticles[0];
+      _targetIndex=1;
+      _beamIndex=0;
     }
  
-    _beamPdg=_inBeam->Pdg();
-    _targetPdg=_inTarget->Pdg();
+    _beamPdg=_initialParticles[_beamIndex]->Pdg();
+    _targetPdg=_initialParticles[_targetIndex]->Pdg();
   }
   ///////////////////////////////////////////////////////////////
   ///Close the file stream
@@ -56,19 +52,19 @@ namespace elSpectro{
 
   /////////////////////////////////////////////////////////////
   //write all the info required for this event
-  void LundWriter::FillAnEvent(){
+  void LundWriter::FillAnEvent(const EventRecord& event){
      
     ////fill _stream
-    StreamEventInfo();
+    StreamEventInfo(event);
  
     _id=1;//reset particle ID counter
  
    
     //final particles
     int final_status=1;
-    for(const auto* p:_finalParticles){
-     
-      StreamParticle(p,final_status);
+    for(const auto& p:event.Particles()){
+      if(p._status!=RecordStatus::Final) continue;
+      StreamParticle(event,p,final_status);
   
      }
       
@@ -80,13 +76,6 @@ namespace elSpectro{
 
   /////////////////////////////////////////////////////////
  
-  /////////////////////////////////////////////////////////
-  void LundWriter::Write(){
-    //write stream
-    _file<<_stream.rdbuf();
-    //reset stream
-    _stream.clear();
-  }
 
  
 }
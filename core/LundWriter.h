@@ -31,8 +31,8 @@ namespace elSpectro{
      LundWriter& operator=(LundWriter&& other) = default;
      
      void WriteHeader() final{};
-     void FillAnEvent() final;
-     void Write() final;
+     using Writer::FillAnEvent;
+     void FillAnEvent(const EventRecord& event) final;
      void End() final;
      void Init() final;
      void NewFile();
@@ -40,32 +40,29 @@ namespace elSpectro{
    private:
      //streaming functions
      
-     void StreamEventInfo(){
+     void StreamEventInfo(const EventRecord& event){
        // Header (Event Info):
        // # of Particles, # of Target Nucleons, # of Target Protons,
        // Pol. of Target, Pol. of Electron,
        // BeamType, BeamEnergy,Target ID, ProcessID, Weight
   
-       _stream<< "\t "<<_finalParticles.size()<<" "<<1<<" "<<1
+       const auto& particles=event.Particles();
+       _stream<< "\t "<<event.NParticles(RecordStatus::Final)<<" "<<1<<" "<<1
 	      <<" "<<0.<<" "<<0.
-	      <<" "<<_beamPdg<<" "<<_inBeam->P4().E()<<" "<<_targetPdg<<" "<< _inTarget->P4().E() <<" "<<0.<<"\n";
+	      <<" "<<_beamPdg<<" "<<particles[_beamIndex]._p4.E()<<" "<<_targetPdg<<" "<< particles[_targetIndex]._p4.E() <<" "<<event.Weight()<<"\n";
      }
-     void StreamParticle(const Particle* p,int status){
-       auto p4=p->P4();
-       auto ver=p->VertexPosition();
+     void StreamParticle(const EventRecord& event,const RecordParticle& p,int status){
+       const auto& p4=p._p4;
+       const auto& ver=event.Vertices()[p._vertex];
        //second entry 0. == lifetime Could add to Particle.h
        //note convert vertex mm->cm
        _stream<<_id++<<" "<<0.<<" "<<status
-	      <<" "<<p->Pdg()<<" "<<0<<" "<<0<<" "
+	      <<" "<<p._pdg<<" "<<0<<" "<<0<<" "
 	      <<p4.X()<<" "<<p4.Y()<<" "<<p4.Z()<<" "<<p4.T()<<" "
-	      <<p4.M()<<" "<<ver->X()/10<<" "<<ver->Y()/10<<" "<<ver->Z()/10<<"\n";
+	      <<p4.M()<<" "<<ver.X()/10<<" "<<ver.Y()/10<<" "<<ver.Z()/10<<"\n";
      }
    
      //data members
-     std::ofstream _file; //! output file
-     //std::ostream _stream; //! output stream
-     std::stringstream _stream;
-     std::string _filename;
      
      long _nEvent={0};
      int _nFile={1};
@@ -75,8 +72,8 @@ namespace elSpectro{
      int _beamPdg=0;
      int _targetPdg=0;
      
-     const Particle* _inBeam={nullptr};
-     const Particle* _inTarget={nullptr};
+     size_t _beamIndex={0}; //in EventRecord::Particles()
+     size_t _targetIndex={1};
      
      ClassDef(elSpectro::LundWriter,1); //class Writer
    };
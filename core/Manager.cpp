@@ -1 +1,171 @@
 #include "Manager.h"
+#include "FunctionsForThreads.h"
+#include <TSystem.h>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace elSpectro{
+
+  namespace{
+    thread_local Manager* currentManager=nullptr;
+  }
+  
+  ///////////////////////////////////////////////////////////
+  Manager* Manager::Current() noexcept{
+    if(currentManager!=nullptr) return currentManager;
+    static Manager instance;
+    return &instance;
+  }
+  ///////////////////////////////////////////////////////////
+  void Manager::SetCurrent(Manager* man) noexcept{
+    currentManager=man;
+  }
+  ///////////////////////////////////////////////////////////
+  RunStatistics Manager::Statistics() const{
+    RunStatistics stats;
+    stats._nEvents=_nEventsDone;
+    if(_process.get()) stats._nSamples=_process->NSamples();
+    stats._phaseSpaceCalcs=_massPhaseSpace.NumberOfCalcs();
+    stats._phaseSpaceSuccesses=_massPhaseSpace.NumberOfSuccesses();
+    stats._integralXSection=_integralXSection;
+    return stats;
+  }
+  
+  ///////////////////////////////////////////////////////////
+  ///Same as the macro event loop but keeping a copy of each
+  ///event in structure-of-arrays form
+  const EventBlock& Manager::GenerateBatch(size_t n){
+    _block.Clear();
+    _block.Reserve(n);
+    while(_block.NEvents()<n && Finished()==false){
+      Clear();
+      _process->GenerateProducts();
+      Write();
+      CountEvent();
+      _block.AddEvent(CurrentEvent());
+    }
+    return _block;
+  }
+  ///////////////////////////////////////////////////////////
+  ///Fork _nJobs workers, each generates its share of events on
+  ///its own random stream and writer shard, then returns here
+  ///to continue the event loop. This process waits for them,
+  ///merges their statistics and output and finishes the loop
+  void Manager::RunJobs(){
+    _jobsRun=true;
+
+    const auto seed=rng().GetSeed();
+    std::cout<<"Manager::RunJobs() forking "<<_nJobs<<" jobs for "<<_nEventsToGen<<" events with seed "<<seed<<std::endl;
+    //nothing buffered should be written twice
+    if(_writer.get()) _writer->Flush();
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    std::vector<pid_t> pids;
+    std::vector<int> pipes;
+    for(int ijob=0;ijob<_nJobs;++ijob){
+      int fds[2];
+      if(pipe(fds)!=0){
+	std::cerr<<"Manager::RunJobs could not create pipe, exiting..."<<std::endl;
+	exit(0);
+      }
+      auto pid=fork();
+      if(pid<0){
+	std::cerr<<"Manager::RunJobs could not fork, exiting..."<<std::endl;
+	exit(0);
+      }
+      if(pid==0){ //worker
+	close(fds[0]);
+	for(auto fd:pipes) close(fd);
+	_jobIndex=ijob;
+	_jobPipe=fds[1];
+	//same seed, independent streams, stream 0 was used for initialisation
+	setThreadRandomEngine(nullptr);
+	setDefaultRandomEngine(new PhiloxEngine{seed,static_cast<uint64_t>(ijob+1)});
+	gRandom->SetSeed(seed+ijob+1);
+	//the jobs share the cores
+	threads::setJobs(_nJobs);
+	_nEventsToGen=ShareOfEvents(_nEventsToGen,ijob,_nJobs);
+	_nEventsDone=0;
+	if(_writer.get()) _writer->OpenShard(ijob);
+	return;
+      }
+      close(fds[1]);
+      pids.push_back(pid);
+      pipes.push_back(fds[0]);
+    }
+
+    //collect the counters from each worker
+    _jobStats=RunStatistics{};
+    for(int ijob=0;ijob<_nJobs;++ijob){
+      RunStatistics stats;
+      auto bytes=reinterpret_cast<char*>(&stats);
+      size_t got=0;
+      while(got<sizeof(stats)){
+	auto n=read(pipes[ijob],bytes+got,sizeof(stats)-got);
+	if(n<=0) break;
+	got+=n;
+      }
+      close(pipes[ijob]);
+      int status=0;
+      waitpid(pids[ijob],&status,0);
+      if(got!=sizeof(stats)||!WIFEXITED(status)){
+	std::cerr<<"Manager::RunJobs job "<<ijob<<" did not finish, its events are missing"<<std::endl;
+	continue;
+      }
+      _jobStats+=stats;
+    }
+    if(_jobStats._integralXSection==0) _jobStats._integralXSection=_integralXSection;
+
+    if(_writer.get()){
+      _writer->End();
+      std::vector<std::string> shards;
+      for(int ijob=0;ijob<_nJobs;++ijob)
+	shards.push_back(Writer::ShardFileName(_writer->FileName(),ijob));
+      _writer->MergeShards(shards,_writer->FileName());
+      for(const auto& shard:shards)
+	gSystem->Unlink(shard.c_str());
+    }
+    //nothing left for the event loop in this process
+    _nEventsDone=_nEventsToGen;
+  }
+  ///////////////////////////////////////////////////////////
+  ///Worker has generated its events, send its counters
+  ///and leave without returning to the macro
+  void Manager::EndJob(){
+    if(_writer.get()) _writer->End();
+    auto stats=Statistics();
+    auto bytes=reinterpret_cast<const char*>(&stats);
+    size_t sent=0;
+    while(sent<sizeof(stats)){
+      auto n=write(_jobPipe,bytes+sent,sizeof(stats)-sent);
+      if(n<=0) break;
+      sent+=n;
+    }
+    close(_jobPipe);
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+    //skip static destructors and ROOT cleanup shared with the parent
+    _exit(0);
+  }
+  
+  ///////////////////////////////////////////////////////////
+  RunStatistics& RunStatistics::operator+=(const RunStatistics& other){
+    _nEvents+=other._nEvents;
+    _nSamples+=other._nSamples;
+    _phaseSpaceCalcs+=other._phaseSpaceCalcs;
+    _phaseSpaceSuccesses+=other._phaseSpaceSuccesses;
+    //same reaction so same cross section, just take any calculated one
+    if(_integralXSection==0) _integralXSection=other._integralXSection;
+    return *this;
+  }
+  ///////////////////////////////////////////////////////////
+  void RunStatistics::Print() const{
+    std::cout<<"Generated events = "<<_nEvents<<" from reaction samples = "<<_nEvents+_nSamples<<std::endl;
+    std::cout<<"MassPhaseSpace number calcs= "<<_phaseSpaceCalcs<<" number of successes = "<<_phaseSpaceSuccesses<<" ratio  ="<< (_phaseSpaceCalcs ? double(_phaseSpaceSuccesses)/_phaseSpaceCalcs : 0.) <<std::endl;
+    std::cout<<"Integrated Total Cross Section (nb) = "<<_integralXSection<<std::endl;
+  }
+}
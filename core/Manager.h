@@ -6,6 +6,18 @@
 ///           1) Access ParticleManager via Manager::Instance()->Particles()
 ///           2) Access DecayManager via Manager::Instance()->Decays()
 ///           3) Access ProductionProcess via Manager::Instance()->Process()
+///           Instance() returns the Manager current on the calling thread,
+///           this is the global one unless a GeneratorContext has been
+///           activated, allowing independent event loops on many threads
+///           SetJobs(N) forks N worker processes when the event loop
+///           starts, each generates its share of events into its own
+///           writer shard, which are merged when all are finished
+///           Cache() stores slow initialisation results for later jobs
+///           SetAdaptiveEnvelopes() raises envelopes which are exceeded
+///           and gives events a correction weight instead, for decays
+///           which regenerate their parent on failure
+///           SetWeightedEvents() keeps every proposed event and
+///           gives it the product of the accept/reject ratios
 #pragma once
 
 #include "ParticleManager.h"
@@ -13,16 +25,35 @@
 #include "ProductionProcess.h"
 #include "Writer.h"
 #include "MassPhaseSpace.h"
+#include "EventBlock.h"
+#include "InitCache.h"
+#include "ThreadRandom.h"
 #include <TRandom3.h>
 
 namespace elSpectro{
 
+  ///Counters needed to combine Summary() of independent event loops
+  struct RunStatistics{
+    long long _nEvents={0};
+    long _nSamples={0};
+    long _phaseSpaceCalcs={0};
+    long _phaseSpaceSuccesses={0};
+    double _integralXSection={0};
+
+    RunStatistics& operator+=(const RunStatistics& other);
+    void Print() const;
+  };
+  
   class Manager{
 
   public:
     
-     static Manager& Instance() { static Manager instance; return instance; }
+    static Manager& Instance() { return *Current(); }
     static void Reset(){Instance() = Manager();}
+    //Manager used by Instance() on this thread
+    static Manager* Current() noexcept;
+    //nullptr => return to the global Manager
+    static void SetCurrent(Manager* man) noexcept;
 
     ParticleManager& Particles() noexcept{return _particles;}
      DecayManager& Decays() noexcept{return _decays;}
@@ -40,10 +71,22 @@ namespace elSpectro{
      void CountEvent(){_nEventsDone++;}
   
      bool Finished(){
-       if(_nEventsDone==_nEventsToGen)
+       //first call from the event loop, reaction already initialised
+       if(_nJobs>1 && _jobIndex<0 && _jobsRun==false) RunJobs();
+       if(_nEventsDone==_nEventsToGen){
+	 if(_jobIndex>=0) EndJob(); //worker process does not return
 	 return true;
+       }
        return false;
      }
+
+     //number of worker processes for the event loop
+     void SetJobs(int n){_nJobs = n>0 ? n : 1;}
+     int GetJobs()const noexcept{return _nJobs;}
+     //events for job ishard when total is shared between nshards
+     static long long ShareOfEvents(long long total,int ishard,int nshards){
+       return total/nshards + (ishard < total%nshards ? 1 : 0);
+     }
      
      double IntegratedXSection()const {return _integralXSection;}
      void SetNEvents(double n){_nEventsToGen=n;}
@@ -79,20 +122,36 @@ namespace elSpectro{
     }
     ProductionProcess* Reaction(){return _process.get();}
 
-     void SetSeed(ULong_t seed = 0){gRandom->SetSeed(seed);}
+     void SetSeed(ULong_t seed = 0){rng().SetSeed(seed);}
+
+     InitCache& Cache() noexcept{return _cache;}
 
 
      void SetModelForMassPhaseSpace(DecayModel* amodel){_massPhaseSpace.SetModel(amodel);}
     void SuppressPhaseSpace(double val){_massPhaseSpace.SuppressPhaseSpace(val);}
      void  FindMassPhaseSpace(double parentM,const  DecayModel* amodel) {
-       _massPhaseSpace.Find(parentM,amodel);
+       _massPhaseSpace.Find(parentM,amodel,_nEventsDone);
+     }
+     double MassPhaseSpaceWeight()const noexcept{return _massPhaseSpace.CorrectionWeight();}
+
+     //envelopes which are exceeded are raised and the event weighted
+     //by the correction, see EnvelopeAdaptor
+     void SetAdaptiveEnvelopes(bool use=true){
+       _adaptiveEnvelopes=use;
+       _massPhaseSpace.SetCorrectionWeights(use);
      }
+     bool AdaptiveEnvelopes()const noexcept{return _adaptiveEnvelopes;}
+     //accept/reject nodes multiply their ratio into the event weight
+     //rather than reject, see UnweightingWriter to unweight afterwards
+     void SetWeightedEvents(bool use=true){_weightedEvents=use;}
+     bool WeightedEvents()const noexcept{return _weightedEvents;}
      bool  AcceptPhaseSpace(double parentM) {
        return _massPhaseSpace.AcceptPhaseSpace(parentM);
      }
 
      void InitGeneration(){
        _process->InitGen();
+       _process->InitEventRecord();
        if( _writer.get() )_writer->Init();
      }
 
@@ -101,18 +160,31 @@ namespace elSpectro{
        return (_vertices.size()-1);
      }
      std::vector<const LorentzVector*>& GetVertices(){return _vertices;}
+     //copy of the last generated event
+     const EventRecord& CurrentEvent()const {return _process->CurrentEvent();}
+     //generate and write up to n events, fewer if Finished()
+     const EventBlock& GenerateBatch(size_t n);
      
      void Clear(){
      
      }
 
      void Summary(){
+       if(_jobsRun){
+	 std::cout<<"Manager::Summary() combined from "<<_nJobs<<" jobs"<<std::endl;
+	 _jobStats.Print();
+	 return;
+       }
        _process->Print();
       _massPhaseSpace.Print();
       std::cout<<"Integrated Total Cross Section (nb) = "<<IntegratedXSection()<<std::endl;
       }
+     RunStatistics Statistics() const;
   private:
 
+    void RunJobs();
+    void EndJob();
+
     ParticleManager _particles;
     DecayManager _decays;
 
@@ -122,11 +194,21 @@ namespace elSpectro{
     std::vector<const LorentzVector*> _vertices;
     
     MassPhaseSpace _massPhaseSpace;
+    InitCache _cache;
 
 
     double _integralXSection={0};
     long long _nEventsToGen={0};
     long long _nEventsDone={0};
+
+    EventBlock _block;//!
+    RunStatistics _jobStats;//!
+    int _nJobs={1};//!
+    int _jobIndex={-1};//! >=0 in a worker process
+    int _jobPipe={-1};//!
+    bool _jobsRun={false};//!
+    bool _adaptiveEnvelopes={false};
+    bool _weightedEvents={false};
     
     ClassDef(elSpectro::Manager,1); //class Manager
   };
@@ -1,9 +1,49 @@
 #include "MassPhaseSpace.h"
+#include "FunctionsForKinematics.h"
 
 
 namespace elSpectro{
 
+  ///////////////////////////////////////////////////////////
+  ///Phase space weight grows with W so the bin maximum is at
+  ///its high edge. Take the largest of _pilotN sampled weights
+  ///there, or the equal distribution estimate if that is larger
+  double MassPhaseSpace::MaxWeight(size_t ibin){
+    if(ibin>=_maxTable.size()){
+      _maxTable.resize(ibin+1,0.);
+      _sumWeights.resize(ibin+1,0.);
+      _sumAccWeights.resize(ibin+1,0.);
+    }
+    if(_maxTable[ibin]>0) return _maxTable[ibin];
 
+    auto W=MaxWeightBinHighEdge(ibin);
+    double max=kine::PhaseSpaceWeightMaxFromEquDist(W,_masses);
+    auto pilot=PilotWeights(W);
+    for(auto wee:pilot)
+      if(wee>max) max=wee;
+    _maxTable[ibin]=max*(1+_maxMargin);
+    SeedWeightSums(ibin,pilot);
+    return _maxTable[ibin];
+  }
+  ///////////////////////////////////////////////////////////
+  std::vector<double> MassPhaseSpace::PilotWeights(double W) const{
+    std::vector<double> weights(_pilotN);
+    for(auto& wee:weights)
+      wee=TMath::Sqrt(_model->PhaseSpaceWeightSq(W));
+    return weights;
+  }
+  ///////////////////////////////////////////////////////////
+  ///The correction weight mean starts from the pilot scan so
+  ///the first events in a bin are not normalised by their own trials
+  void MassPhaseSpace::SeedWeightSums(size_t ibin,const std::vector<double>& weights){
+    const double accMax=_maxTable[ibin]*_suppressPhaseSpace;
+    _sumWeights[ibin]=0;
+    _sumAccWeights[ibin]=0;
+    for(auto wee:weights){
+      _sumWeights[ibin]+=wee;
+      _sumAccWeights[ibin]+=std::min(wee,accMax);
+    }
+  }
  
 
 }
@@ -7,10 +7,23 @@
 ///            Needs to be given the primary decay to calculate
 ///            the Mass phase space element for all children
 ///            and allocate masses for all particles in the chain
+///            Masses are accepted against a table of the maximum
+///            weight in bins of W. A bin is filled by a pilot scan
+///            the first time it is used and raised if a larger
+///            weight is found while generating
+///            Correction weights for masses above the maximum are
+///            normalised to their mean in the W bin, the masses are
+///            conditional on W so must not change its weight. The mean
+///            is estimated from the pilot scan at the bin's high edge
+///            plus all trials so far, so weights depend a little on the
+///            order of events and are only exactly unbiased in the limit
 #pragma once
 
 #include "DecayModel.h"
-#include <TRandom.h>
+#include "ThreadRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 namespace elSpectro{
 
@@ -22,8 +35,16 @@ namespace elSpectro{
   public:
     void Print(){
       std::cout<<"MassPhaseSpace number calcs= "<<_weightCalcN<<" number of successes = "<<_successN<<" ratio  ="<< double(_successN)/_weightCalcN <<std::endl;
+      std::cout<<"               max weight bins filled "<<std::count_if(_maxTable.begin(),_maxTable.end(),[](double m){return m>0;})<<" raised while generating "<<_maxRaisedN<<std::endl;
     }
     void SuppressPhaseSpace(double val){_suppressPhaseSpace=val;}
+    void SetPilotCalls(long n){_pilotN=n;}
+    //weight of the last masses, max(1,weight/maximum) over its mean
+    //in this W bin, only when SetCorrectionWeights(true)
+    double CorrectionWeight()const noexcept{return _correctionWeight;}
+    const std::vector<long long>& ExceededEvents()const noexcept{return _exceededEvents;}
+    long NumberOfCalcs()const noexcept{return _weightCalcN;}
+    long NumberOfSuccesses()const noexcept{return _successN;}
   private:
     
     friend Manager; //only Manager can construct and use a MassPhaseSpace
@@ -35,7 +56,7 @@ namespace elSpectro{
       return result;
     }
 
-    void Find(double parentM,const  DecayModel* amodel){
+    void Find(double parentM,const  DecayModel* amodel,long long event){
       //sample all masses according to overall decay phase space
       if(_model==nullptr) return;
       if(_model!=amodel) return; //only 1 model controls phasespace
@@ -44,32 +65,47 @@ namespace elSpectro{
 
       // double max= kine::PhaseSpaceWeightMax(parentM,_masses);//TGenPhaseSpace max . Note this is too high an estimate
 
-      //Note PhaseSpaceWeightMaxFromEquDist does not quite get to max, so increase by 10% to be safe....will give warning if event weight is above this....
-      double max= kine::PhaseSpaceWeightMaxFromEquDist(parentM,_masses)*1.2;
-      //double max= kine::PhaseSpaceWeightMaxFromEquDist(parentM,_masses);
       //accept or reject mass combinations until got one
       //as W dependence accounted for elsewere
       //PhaseSpaceWeight will try alternative masses
+      //stays accept/reject for weighted events, the masses are
+      //conditional on parentM and the max is not their normalisation
+      auto ibin=MaxWeightBin(parentM);
+      double max=MaxWeight(ibin);
+      const double accMax=max*_suppressPhaseSpace;
       double wee=0;
-    
-      while( (wee=PhaseSpaceWeight(parentM)) < gRandom->Uniform()*max*_suppressPhaseSpace )
-	{
-	  
-
-	  // if(wee>max){
-	  // _sampledMax=wee;
-	  //  std::cout<<" weight >  max "<<wee<<" "<<max<<" normal max "<<kine::PhaseSpaceWeightMax(parentM,_masses)<<std::endl;
-	  // }
-	//reject this combintation
-	  //	if(wee==0)	std::cout<<"ps "<<wee <<" "<<max<<" W "<<parentM<<" sample max"<<_sampledMax<<std::endl;
+      _correctionWeight=1;
+
+      //sums over every trial in this W bin for the mean correction
+      auto& sumW=_sumWeights[ibin];
+      auto& sumAcc=_sumAccWeights[ibin];
+      if(_correctionWeights && sumW==0)
+	SeedWeightSums(ibin,PilotWeights(MaxWeightBinHighEdge(ibin)));
+      while(true){
+	wee=PhaseSpaceWeight(parentM);
+	if(_correctionWeights){
+	  sumW+=wee;
+	  sumAcc+=std::min(wee,accMax);
+	}
+	if(wee >= rng().Uniform()*accMax) break;
       }
+      
+      //accepted with probability min(wee/accMax,1) so weight
+      //max(wee/accMax,1), its mean for a fixed W is
+      //sum(wee)/sum(min(wee,accMax)) and every event here must
+      //be divided by that so the W distribution is unchanged
+      if(_correctionWeights && sumW>0)
+	_correctionWeight=std::max(wee/accMax,1.)*sumAcc/sumW;
       if(wee>max){
-	// _sampledMax=wee;
-	std::cerr<<"MassPhaseSpace check weight >  max,  W "<<parentM<<" this "<<wee<<" "<<max<<" normal max "<<kine::PhaseSpaceWeightMax(parentM,_masses)<<std::endl;
-	std::cout<<" parent "<<parentM<<" ";
-	for(auto& m:_masses)
-	  std::cout<<m<<" ";
-	std::cout<<std::endl;
+	//pilot missed this region, raise the bin for future events
+	if(_maxRaisedN++<10)
+	  std::cerr<<"MassPhaseSpace check weight >  max,  W "<<parentM<<" this "<<wee<<" "<<max<<" raising max for this W bin"<<std::endl;
+	_maxTable[ibin]=wee*(1+_maxMargin);
+	_exceededEvents.push_back(event);
+	//no earlier trial exceeds the new max, else a new pilot
+	//before the next event, not now as it would change the masses
+	if(_suppressPhaseSpace>=1) sumAcc=sumW;
+	else sumW=sumAcc=0;
       }
 
       _successN++;
@@ -86,15 +122,35 @@ namespace elSpectro{
       auto weight = PhaseSpaceWeight(parentM);
       std::cout<<"AcceptPhaseSpace "<<parentM<<" "<< weight<<" "<<max<<std::endl;
       
-      return ( weight > gRandom->Uniform()*max ) ?
+      return ( weight > rng().Uniform()*max ) ?
 	true : false;  
     }
     
+    void SetCorrectionWeights(bool use){_correctionWeights=use;}
+    
     void SetModel(DecayModel* amodel){
       _model=amodel;
       _masses.clear();
       _model->GetStableMasses(_masses); //fill masses vector
+      _threshold=std::accumulate(_masses.begin(),_masses.end(),0.);
+      _maxTable.clear();
+      _sumWeights.clear();
+      _sumAccWeights.clear();
     }
+
+    //bins are logarithmic in W-threshold, upper edge of bin i at
+    //_binT0*(1+_binStep)^(i+1), all W closer to threshold in bin 0
+    size_t MaxWeightBin(double parentM) const noexcept{
+      auto T=parentM-_threshold;
+      if(T<=_binT0) return 0;
+      return static_cast<size_t>(std::log(T/_binT0)/std::log1p(_binStep));
+    }
+    double MaxWeightBinHighEdge(size_t ibin) const noexcept{
+      return _threshold+_binT0*std::pow(1+_binStep,ibin+1);
+    }
+    double MaxWeight(size_t ibin);
+    std::vector<double> PilotWeights(double W) const;
+    void SeedWeightSums(size_t ibin,const std::vector<double>& weights);
     
  
     DecayModel* _model=nullptr;
@@ -103,6 +159,19 @@ namespace elSpectro{
     mutable long _weightCalcN=0;
     mutable long _successN=0;
     double _suppressPhaseSpace=1;
+
+    std::vector<double> _maxTable;//! max weight per W bin, 0 until pilot scan
+    std::vector<double> _sumWeights;//! sum of trial weights per W bin
+    std::vector<double> _sumAccWeights;//! same limited to the accept max
+    double _threshold=0; //sum of stable masses
+    double _binT0=1E-3; //GeV above threshold
+    double _binStep=0.01; //relative bin width in W-threshold
+    double _maxMargin=0.05;
+    long _pilotN=1000;
+    long _maxRaisedN=0;
+    std::vector<long long> _exceededEvents;//!
+    double _correctionWeight=1;
+    bool _correctionWeights=false;
     
     ClassDef(elSpectro::MassPhaseSpace,1); //class MassPhaseSpace
   };
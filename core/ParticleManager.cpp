@@ -1,43 +1,47 @@
 #include "ParticleManager.h"
 #include <TDatabasePDG.h>
 #include <TSystem.h>
+#include <mutex>
 
 namespace elSpectro{
 
   ParticleManager::ParticleManager(){
-    
-    TDatabasePDG *pdgDB = new TDatabasePDG();
-    pdgDB->ReadPDGTable(Form("%s/etc/el_pdg_table.txt",gSystem->Getenv("ELSPECTRO")));
+    //pdg table is global, only fill it for the first manager
+    //(e.g. not again for every parallel GeneratorContext)
+    static std::once_flag pdgTableFlag;
+    std::call_once(pdgTableFlag,[](){
+      TDatabasePDG *pdgDB = new TDatabasePDG();
+      pdgDB->ReadPDGTable(Form("%s/etc/el_pdg_table.txt",gSystem->Getenv("ELSPECTRO")));
  
-    //name,title,mass,stable,width,charge,type.code 
-    pdgDB->AddParticle("gamma_star","gamma_star", 0.0, kFALSE,
-		       0, 0, "virtual", -22);
-    pdgDB->AddParticle("gamma_star_nucleon","gamma_star_nucleon",
-		       pdgDB->GetParticle("proton")->Mass(), kFALSE,
-		       0, 0, "virtual", -2211);
+      //name,title,mass,stable,width,charge,type.code 
+      pdgDB->AddParticle("gamma_star","gamma_star", 0.0, kFALSE,
+  		       0, 0, "virtual", -22);
+      pdgDB->AddParticle("gamma_star_nucleon","gamma_star_nucleon",
+  		       pdgDB->GetParticle("proton")->Mass(), kFALSE,
+  		       0, 0, "virtual", -2211);
 
-    //arbitrary resonaces for decaying
-    pdgDB->AddParticle("resonance5","resonance1",
-		       0, kFALSE,
-		       0, 0, "virtual", 9995);
-    pdgDB->AddParticle("resonance6","resonance1",
-		       0, kFALSE,
-		       0, 0, "virtual", 9996);
-    pdgDB->AddParticle("resonance7","resonance1",
-		       0, kFALSE,
-		       0, 0, "virtual", 9997);
-    pdgDB->AddParticle("resonance8","resonance1",
-		       0, kFALSE,
-		       0, 0, "virtual", 9998);
-    pdgDB->AddParticle("resonance9","resonance1",
-		       0, kFALSE,
-		       0, 0, "virtual", 9999);
+      //arbitrary resonaces for decaying
+      pdgDB->AddParticle("resonance5","resonance1",
+  		       0, kFALSE,
+  		       0, 0, "virtual", 9995);
+      pdgDB->AddParticle("resonance6","resonance1",
+  		       0, kFALSE,
+  		       0, 0, "virtual", 9996);
+      pdgDB->AddParticle("resonance7","resonance1",
+  		       0, kFALSE,
+  		       0, 0, "virtual", 9997);
+      pdgDB->AddParticle("resonance8","resonance1",
+  		       0, kFALSE,
+  		       0, 0, "virtual", 9998);
+      pdgDB->AddParticle("resonance9","resonance1",
+  		       0, kFALSE,
+  		       0, 0, "virtual", 9999);
 
-    pdgDB->AddParticle("deuteron","deuteron", 1.875612, kTRUE,0, 1, "Baryon", 45); //Jlab CLAS numbering
-    pdgDB->AddParticle("deuteron","deuteron", 1.875612, kTRUE,0, 1, "Baryon", 1000010020); //PDG code numbering
+      pdgDB->AddParticle("deuteron","deuteron", 1.875612, kTRUE,0, 1, "Baryon", 45); //Jlab CLAS numbering
+      pdgDB->AddParticle("deuteron","deuteron", 1.875612, kTRUE,0, 1, "Baryon", 1000010020); //PDG code numbering
 
-    //Lambda des not have lifetime in pdg_table.txt
-    
+      //Lambda des not have lifetime in pdg_table.txt
+    });
   }
   Particle*  ParticleManager::Take(Particle* p){
     _particles.push_back(particle_uptr{p});
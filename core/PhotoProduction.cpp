@@ -190,9 +190,14 @@ namespace elSpectro{
     }//DecayModelW
     
      
+    //still in nucleon rest frame
+    auto kinematics=Kinematics(_reactionInfo);
+    
     //Boost all stable particles back to lab
     auto prBoost=_beamNucl.P4().BoostToCM();
     Manager::Instance().Particles().BoostStable(-prBoost);
+
+    FillEventRecord(kinematics);
    
     return DecayStatus::Decayed;
   }
@@ -71,7 +71,6 @@ namespace elSpectro{
     double _Emax={0};
 
     
-    long _nsamples=0;
     int _pdgIon={2212}; //species of ion
 
     short _cacheIntegrals={0};
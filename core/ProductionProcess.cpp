@@ -1,5 +1,7 @@
 #include "ProductionProcess.h"
 #include "Manager.h"
+#include <functional>
+#include <map>
 
 namespace elSpectro{
 
@@ -66,4 +68,69 @@ namespace elSpectro{
      DecayingParticle::PostInit(info);
   
   }
+  //////////////////////////////////////////////////////////////////
+  ///Initial particles, then decaying particles through the decay
+  ///chain (parents first), then the stable particles in the
+  ///order used by ParticleManager
+  void ProductionProcess::InitEventRecord(){
+    _recordParticles.clear();
+    _recordStatus.clear();
+    _recordParents.clear();
+
+    for(const auto* p:_initialParticles){
+      _recordParticles.push_back(p);
+      _recordStatus.push_back(RecordStatus::Initial);
+      _recordParents.push_back(-1);
+    }
+
+    std::map<const Particle*,int> stableParents;
+    std::function<void(const DecayingParticle*,int)> addProducts=
+      [this,&stableParents,&addProducts](const DecayingParticle* parent,int iparent){
+      if(parent->Model()==nullptr) return;
+      for(const auto* prod:parent->Model()->Products()){
+	auto dp=dynamic_cast<const DecayingParticle*>(prod);
+	if(dp==nullptr){
+	  stableParents[prod]=iparent;
+	  continue;
+	}
+	_recordParticles.push_back(dp);
+	_recordStatus.push_back(dp->IsDecay()==DecayType::Detached ?
+				RecordStatus::Detached : RecordStatus::Decayed);
+	_recordParents.push_back(iparent);
+	addProducts(dp,_recordParticles.size()-1);
+      }
+    };
+    addProducts(this,-1);
+
+    for(const auto* p:Manager::Instance().Particles().StableParticles()){
+      _recordParticles.push_back(p);
+      _recordStatus.push_back(RecordStatus::Final);
+      _recordParents.push_back(stableParents.count(p) ? stableParents[p] : -1);
+    }
+  }
+  //////////////////////////////////////////////////////////////////
+  void ProductionProcess::FillEventRecord(const ReactionKinematics& kin){
+    _eventRecord.Clear();
+    _eventRecord.SetKinematics(kin);
+    for(size_t i=0;i<_recordParticles.size();++i)
+      _eventRecord.AddParticle(_recordParticles[i],_recordStatus[i],_recordParents[i]);
+    for(const auto* v:Manager::Instance().GetVertices())
+      _eventRecord.AddVertex(*v);
+    _eventRecord.SumDecayProducts();
+
+    //envelope corrections of all decays in the chain
+    double weight=_samplerWeight*EnvelopeWeight()*Manager::Instance().MassPhaseSpaceWeight();
+    for(const auto* p:_recordParticles)
+      if(auto dp=dynamic_cast<const DecayingParticle*>(p))
+	weight*=dp->EnvelopeWeight();
+    _eventRecord.SetWeight(weight);
+  }
+  //////////////////////////////////////////////////////////////////
+  ReactionKinematics ProductionProcess::Kinematics(const ReactionPhotoProd& info){
+    ReactionKinematics kin;
+    if(info._photon) kin._Q2 = -info._photon->M2();
+    if(info._photoN) kin._W = info._photoN->M();
+    if(info._target && info._baryon) kin._t = (*info._target - *info._baryon).M2();
+    return kin;
+  }
 }
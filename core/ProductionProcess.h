@@ -6,6 +6,7 @@
 ///            e.g Electroproduction, Photoproduction
 ///            1) model required to generate
 ///               reaction CoM state(from DecayingParticle)
+///            2) copies each accepted event into an EventRecord
 #pragma once
 
 #include "CurrentEventInfo.h"
@@ -15,6 +16,7 @@
 #include "CollidingParticle.h"
 #include "Distribution.h"
 #include "DistConst.h"
+#include "EventRecord.h"
 
 namespace elSpectro{
 
@@ -58,6 +60,9 @@ namespace elSpectro{
 
     virtual double dsigma() const{return 1;}
 
+    //GenerateProducts makes a new collision whenever the chain fails
+    bool RegeneratesOnFail() const override {return true;}
+
     virtual void GenerateVertexPosition()  noexcept override{
       SetVertexXYZT(_xvertexDist->SampleSingle(),
 		    _yvertexDist->SampleSingle(),
@@ -79,8 +84,26 @@ namespace elSpectro{
     void SetBoostToLab(const elSpectro::BetaVector& boostv){
       _boostToLab=boostv;
     }
+
+    //number of rejected reaction samples, for Summary
+    long NSamples()const noexcept{return _nsamples;}
+
+    //order and parents of particles in the record
+    //call once all particles exist, i.e. after InitGen()
+    void InitEventRecord();
+    const EventRecord& CurrentEvent()const noexcept{return _eventRecord;}
+    
   protected:
 
+    //derived GenerateProducts() call when an event is accepted
+    void FillEventRecord(const ReactionKinematics& kin);
+    //Q2, W and t, call before boosting to lab as info
+    //mixes nucleon rest frame and generated vectors
+    static ReactionKinematics Kinematics(const ReactionPhotoProd& info);
+
+    long _nsamples=0;
+    //weight of a sampler proposing the whole reaction, e.g. a foam
+    double _samplerWeight={1};//!
    
     
   private:
@@ -99,6 +122,11 @@ namespace elSpectro{
     
     elSpectro::BetaVector _boostToLab;
 
+    EventRecord _eventRecord;//!
+    particle_constptrs _recordParticles;//!
+    std::vector<RecordStatus> _recordStatus;//!
+    std::vector<int> _recordParents;//!
+
   };
 
 
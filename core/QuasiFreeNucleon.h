@@ -11,7 +11,7 @@
 #include "DistTF1.h"
 #include "DistTH1.h"
 #include "LorentzVector.h"
-#include <TRandom.h> //for gRandom
+#include "ThreadRandom.h"
 #include <Math/VectorUtil.h> //for boosts etc.
 
 namespace elSpectro{
@@ -36,7 +36,7 @@ namespace elSpectro{
 		    const particle_ptrs& products)  final;
 
     double RandomCosTh() const noexcept{
-      return gRandom->Uniform(-1,1);
+      return rng().Uniform(-1,1);
     }
 
 
@@ -0,0 +1,74 @@
+#include "RandomEngine.h"
+#include <random>
+
+namespace elSpectro{
+
+  ///////////////////////////////////////////////////////////
+  PhiloxEngine::PhiloxEngine(uint64_t seed,uint64_t stream):
+    _stream{stream}
+  {
+    SetSeed(seed);
+  }
+  ///////////////////////////////////////////////////////////
+  ///restart the counter with a new key
+  void PhiloxEngine::SetSeed(uint64_t seed){
+    if(seed==0){
+      std::random_device rd;
+      seed = (static_cast<uint64_t>(rd())<<32) ^ rd();
+    }
+    _seed=seed;
+    _counter=0;
+    ClearBuffer();
+  }
+  ///////////////////////////////////////////////////////////
+  ///streams with the same seed never overlap
+  void PhiloxEngine::SetStream(uint64_t stream){
+    _stream=stream;
+    _counter=0;
+    ClearBuffer();
+  }
+  ///////////////////////////////////////////////////////////
+  std::array<uint32_t,4> PhiloxEngine::Philox4x32(std::array<uint32_t,4> ctr,
+						   std::array<uint32_t,2> key) noexcept{
+    constexpr uint32_t M0=0xD2511F53;
+    constexpr uint32_t M1=0xCD9E8D57;
+    constexpr uint32_t W0=0x9E3779B9;
+    constexpr uint32_t W1=0xBB67AE85;
+
+    for(int round=0;round<10;++round){
+      if(round>0){ //bump key
+	key[0]+=W0;
+	key[1]+=W1;
+      }
+      const uint64_t prod0=static_cast<uint64_t>(M0)*ctr[0];
+      const uint64_t prod1=static_cast<uint64_t>(M1)*ctr[2];
+      const uint32_t hi0=static_cast<uint32_t>(prod0>>32);
+      const uint32_t lo0=static_cast<uint32_t>(prod0);
+      const uint32_t hi1=static_cast<uint32_t>(prod1>>32);
+      const uint32_t lo1=static_cast<uint32_t>(prod1);
+      ctr={hi1^ctr[1]^key[0],lo1,hi0^ctr[3]^key[1],lo0};
+    }
+    return ctr;
+  }
+  ///////////////////////////////////////////////////////////
+  ///counter = (block number, stream), key = seed
+  ///each call gives 4 words = 2 doubles with 53 random bits
+  void PhiloxEngine::FillBlock(double* block) noexcept{
+    const std::array<uint32_t,2> key={static_cast<uint32_t>(_seed),
+				      static_cast<uint32_t>(_seed>>32)};
+    const uint32_t stream0=static_cast<uint32_t>(_stream);
+    const uint32_t stream1=static_cast<uint32_t>(_stream>>32);
+
+    constexpr double toUnit=1./9007199254740992.; //2^-53
+    for(size_t i=0;i<kBlockSize;i+=2){
+      auto words=Philox4x32({static_cast<uint32_t>(_counter),
+			     static_cast<uint32_t>(_counter>>32),
+			     stream0,stream1},key);
+      ++_counter;
+      //+0.5 keeps values inside (0,1)
+      block[i]  =((words[0]>>5)*67108864.+(words[1]>>6)+0.5)*toUnit;
+      block[i+1]=((words[2]>>5)*67108864.+(words[3]>>6)+0.5)*toUnit;
+    }
+  }
+
+}
@@ -0,0 +1,136 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		RandomEngine
+///Description:
+///             Interface for uniform random numbers used by samplers
+///             Derived engines fill blocks of numbers, which are
+///             buffered so each draw is an inlined array read
+///             rather than a virtual call
+///
+///Class:		PhiloxEngine
+///Description:
+///             Counter based Philox4x32-10 engine (Salmon et al. 2011)
+///             Independent streams keyed by (seed,stream), e.g. one
+///             stream per thread or process with the same seed
+///
+///Class:		TRandomEngine
+///Description:
+///             Use a ROOT TRandom as engine, e.g. TRandom3
+#pragma once
+
+#include <TRandom.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace elSpectro{
+
+  class RandomEngine{
+
+  public:
+
+    RandomEngine()=default;
+    virtual ~RandomEngine()=default;
+    RandomEngine(const RandomEngine& other)=default;
+    RandomEngine(RandomEngine&&)=default;
+    RandomEngine& operator=(const RandomEngine& other)=default;
+    RandomEngine& operator=(RandomEngine&& other) = default;
+
+    //uniform on (0,1)
+    double Uniform() noexcept{
+      if(_next==kBlockSize) Refill();
+      return _block[_next++];
+    }
+    double Uniform(double x1,double x2) noexcept{
+      return x1 + (x2-x1)*Uniform();
+    }
+    //exponential with mean tau
+    double Exp(double tau) noexcept{
+      return -tau*std::log(Uniform());
+    }
+    void RndmArray(int n,double* array) noexcept{
+      for(int i=0;i<n;++i) array[i]=Uniform();
+    }
+
+    //seed = 0 => engine chooses a unique seed
+    virtual void SetSeed(uint64_t seed) =0;
+    virtual uint64_t GetSeed() const noexcept =0;
+
+  protected:
+
+    //engines provide numbers on (0,1) kBlockSize at a time
+    static constexpr size_t kBlockSize=256;
+    virtual void FillBlock(double* block) noexcept =0;
+
+    //discard any buffered numbers e.g. after reseeding
+    void ClearBuffer() noexcept{_next=kBlockSize;}
+
+  private:
+
+    void Refill() noexcept{
+      FillBlock(_block.data());
+      _next=0;
+    }
+
+    std::array<double,kBlockSize> _block;
+    size_t _next={kBlockSize};
+
+  };
+
+  ///////////////////////////////////////////////////////////
+  class PhiloxEngine : public RandomEngine {
+
+  public:
+
+    PhiloxEngine(uint64_t seed=0,uint64_t stream=0);
+
+    void SetSeed(uint64_t seed) final;
+    uint64_t GetSeed() const noexcept final {return _seed;}
+
+    void SetStream(uint64_t stream);
+    uint64_t GetStream() const noexcept {return _stream;}
+
+    //4 random words for counter under key, exposed for checking
+    static std::array<uint32_t,4> Philox4x32(std::array<uint32_t,4> ctr,
+					      std::array<uint32_t,2> key) noexcept;
+
+  protected:
+
+    void FillBlock(double* block) noexcept final;
+
+  private:
+
+    uint64_t _seed={0};
+    uint64_t _stream={0};
+    uint64_t _counter={0};
+
+  };
+
+  ///////////////////////////////////////////////////////////
+  class TRandomEngine : public RandomEngine {
+
+  public:
+
+    //takes ownership of rand
+    TRandomEngine(TRandom* rand):_random{rand}{}
+
+    void SetSeed(uint64_t seed) final {
+      _random->SetSeed(seed);
+      ClearBuffer();
+    }
+    uint64_t GetSeed() const noexcept final {return _random->GetSeed();}
+
+  protected:
+
+    void FillBlock(double* block) noexcept final{
+      _random->RndmArray(kBlockSize,block);
+    }
+
+  private:
+
+    std::unique_ptr<TRandom> _random;
+
+  };
+
+}//namespace elSpectro
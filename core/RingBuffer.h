@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		RingBuffer
+///Description:
+///             Bounded lock-free queue for one producer thread and
+///             one consumer thread. Slots are preallocated and reused
+///             so objects holding vectors keep their capacity
+///             Producer : if(auto* slot=ring.WriteSlot()){ *slot=...; ring.Publish();}
+///             Consumer : if(auto* slot=ring.ReadSlot()){ use(*slot); ring.Release();}
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace elSpectro{
+
+  template<typename T>
+  class RingBuffer{
+
+  public:
+
+    //capacity rounded up to a power of 2
+    explicit RingBuffer(size_t capacity){
+      size_t size=1;
+      while(size<capacity) size<<=1;
+      _slots.resize(size);
+      _mask=size-1;
+    }
+
+    //nullptr if full
+    T* WriteSlot() noexcept{
+      auto head=_head.load(std::memory_order_relaxed);
+      if(head-_tail.load(std::memory_order_acquire) > _mask) return nullptr;
+      return &_slots[head&_mask];
+    }
+    //make the slot from WriteSlot() visible to the consumer
+    void Publish() noexcept{
+      _head.store(_head.load(std::memory_order_relaxed)+1,std::memory_order_release);
+    }
+
+    //nullptr if empty
+    const T* ReadSlot() noexcept{
+      auto tail=_tail.load(std::memory_order_relaxed);
+      if(tail==_head.load(std::memory_order_acquire)) return nullptr;
+      return &_slots[tail&_mask];
+    }
+    //give the slot from ReadSlot() back to the producer
+    void Release() noexcept{
+      _tail.store(_tail.load(std::memory_order_relaxed)+1,std::memory_order_release);
+    }
+
+    bool Empty() const noexcept{
+      return _head.load(std::memory_order_acquire)==_tail.load(std::memory_order_acquire);
+    }
+    size_t Capacity() const noexcept{return _mask+1;}
+
+  private:
+
+    std::vector<T> _slots;
+    size_t _mask={0};
+    //separate cache lines for producer and consumer indices
+    alignas(64) std::atomic<size_t> _head={0};
+    alignas(64) std::atomic<size_t> _tail={0};
+
+  };
+
+}//namespace elSpectro
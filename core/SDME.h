@@ -44,6 +44,7 @@ namespace elSpectro{
     }
     
     uint Spin()const {return _J;}
+    uint AlphaMax()const {return _alphaMax;}
   private:
   
     uint _J={0};
@@ -25,7 +25,15 @@ namespace elSpectro{
   double ScatteredElectron_xy::Generate(const LorentzVector& parent, const particle_ptrs& products)  {
    
     double xx,yy;
-    std::tie(xx,yy) = _random_xy.SamplePair();
+    if(_useNextXY){
+      std::tie(xx,yy) = _nextXY;
+      _useNextXY=false;
+      _envelopeWeight=1;
+    }
+    else{
+      std::tie(xx,yy) = _random_xy.SamplePair();
+      _envelopeWeight=_random_xy.Weight();
+    }
     CompleteGivenXandY(parent, products, xx, yy);
     double Ee = escat::E_el(parent.Z()); //parent in rest frame of ion, momentum= 
     double Mion= parent.T()-Ee; // energy of parent = Mion + E(e-)
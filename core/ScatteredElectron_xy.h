@@ -30,6 +30,7 @@ namespace elSpectro{
 		    const particle_ptrs& products,double xx, double yy)  ;
     
     DistVirtPhotFlux_xy &Dist(){return _random_xy;}
+    const DistVirtPhotFlux_xy &Dist() const{return _random_xy;}
 
 
     void SetModel(DecayModel* model){_gStarNmodel=model;}
@@ -38,6 +39,12 @@ namespace elSpectro{
 
     double Probability() const final{return _random_xy.Probability();}
 
+    double EnvelopeWeight() const final{return _envelopeWeight;}
+
+    //use x,y for the next Generate instead of sampling the flux
+    //e.g. from a sampler of the full phase space
+    void SetNextXY(double xx,double yy){_nextXY={xx,yy};_useNextXY=true;}
+
     void PostInit(ReactionInfo* info) final;
     
   protected:
@@ -50,6 +57,9 @@ namespace elSpectro{
     DecayModel* _gStarNmodel{nullptr};
     
     DistVirtPhotFlux_xy _random_xy;
+    dist_pair _nextXY={0,0};//!
+    double _envelopeWeight={1};//!
+    bool _useNextXY={false};//!
  
     LorentzVector _scattered;
     LorentzVector _gamma_ion; //residual gamma* + ion system
@@ -0,0 +1,47 @@
+#include "ThreadRandom.h"
+#include <memory>
+
+namespace elSpectro{
+
+  namespace{
+    
+    std::unique_ptr<RandomEngine>& defaultEngine(){
+      static std::unique_ptr<RandomEngine> engine{new PhiloxEngine{4357}};
+      return engine;
+    }
+    thread_local RandomEngine* threadEngine=nullptr;
+
+    //let ROOT functions taking a TRandom use the same stream
+    class EngineTRandom : public TRandom {
+    public:
+      Double_t Rndm() override {return rng().Uniform();}
+      void RndmArray(Int_t n,Float_t* array) override{
+	for(Int_t i=0;i<n;++i) array[i]=rng().Uniform();
+      }
+      void RndmArray(Int_t n,Double_t* array) override{
+	rng().RndmArray(n,array);
+      }
+      void SetSeed(ULong_t seed=0) override{rng().SetSeed(seed);}
+      UInt_t GetSeed() const override{return rng().GetSeed();}
+    };
+    
+  }
+  
+  RandomEngine& rng() noexcept{
+    return threadEngine==nullptr ? *defaultEngine() : *threadEngine;
+  }
+  
+  void setThreadRandomEngine(RandomEngine* engine) noexcept{
+    threadEngine=engine;
+  }
+  
+  void setDefaultRandomEngine(RandomEngine* engine){
+    defaultEngine().reset(engine);
+  }
+  
+  TRandom* threadRandom() noexcept{
+    thread_local EngineTRandom adaptor;
+    return &adaptor;
+  }
+
+}
@@ -0,0 +1,28 @@
+//////////////////////////////////////////////////////////////
+///
+///Functions:	rng, threadRandom
+///Description:
+///             Random numbers used by the samplers.
+///             rng() is the engine for the calling thread, the
+///             default engine unless a GeneratorContext installed
+///             its own stream so parallel loops do not share state.
+///             threadRandom() gives a TRandom drawing from rng()
+///             for ROOT functions needing one, e.g. TF1::GetRandom
+#pragma once
+
+#include "RandomEngine.h"
+#include <TRandom.h>
+
+namespace elSpectro{
+
+  //engine for the calling thread
+  RandomEngine& rng() noexcept;
+  //install engine for the calling thread, nullptr => default engine
+  void setThreadRandomEngine(RandomEngine* engine) noexcept;
+  //replace the default engine (PhiloxEngine), takes ownership
+  void setDefaultRandomEngine(RandomEngine* engine);
+
+  //TRandom interface to rng()
+  TRandom* threadRandom() noexcept;
+
+}//namespace elSpectro
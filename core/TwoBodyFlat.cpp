@@ -24,7 +24,9 @@ namespace elSpectro{
     auto p_a = TMath::Sqrt(e_a*e_a - m2_a); // p for both
     // auto e_b = TMath::Sqrt(p_a*p_a + m2_b); // E for decay product b
 
-    auto costh = RandomCosTh();
+    auto costh = _nextCosTh;
+    if(costh>1) costh = RandomCosTh();
+    _nextCosTh=2;
     auto sinth=TMath::Sqrt(1-costh*costh);
     
     //momentum components in CM frame
@@ -8,7 +8,7 @@
 
 #include "DecayVectors.h"
 #include "LorentzVector.h"
-#include <TRandom.h> //for gRandom
+#include "ThreadRandom.h"
 #include <Math/VectorUtil.h> //for boosts etc.
 
 namespace elSpectro{
@@ -31,11 +31,15 @@ namespace elSpectro{
 		    const particle_ptrs& products)  final;
 
     virtual double RandomCosTh() const noexcept{
-      return gRandom->Uniform(-1,1);
+      return rng().Uniform(-1,1);
     }
     
     double Probability() const{return 1./4/TMath::Pi();}
 
+    //use costh for the next Generate instead of RandomCosTh()
+    //e.g. from a sampler of the full phase space
+    void SetNextCosTh(double costh) const noexcept{_nextCosTh=costh;}
+
 
   protected :
 
@@ -46,6 +50,7 @@ namespace elSpectro{
     LorentzVector _a;
     LorentzVector _b;
     double _W={0};
+    mutable double _nextCosTh={2};//! >1 => RandomCosTh()
  
  
     ClassDef(elSpectro::TwoBodyFlat,1); //class DecayVectors
@@ -9,6 +9,7 @@
 #include "TwoBodyFlat.h"
 #include "FunctionsForKinematics.h"
 #include <Math/VectorUtil.h> //for boosts etc.
+#include <cmath>
 
 namespace elSpectro{
 
@@ -21,7 +22,8 @@ namespace elSpectro{
 
     double RandomCosTh() const noexcept final{
       _weight=1;
-      auto randChannel = gRandom->Uniform();
+      CalcKinematics();
+      auto randChannel = rng().Uniform();
       //  std::cout<<" TwoBody_stu RandomCosTh() "<<randChannel<<std::endl;
       //select s,t or u channel
       double costh=0;
@@ -35,65 +37,43 @@ namespace elSpectro{
       _weight = CalcWeight();
       return costh;
     }
-   
-    double CosThFrom_t() const noexcept {
-       
+
+    //CosThFrom_ and CalcWeight use the CM momenta and t limits
+    //from the last CalcKinematics()
+    void CalcKinematics() const noexcept {
       double W = _CM->M();
       double M1=_p1->M();
-      // double M1=0;
-      double M2=_p2->M();
       double M3=_p3->M();
       double M4=_p4->M();
       
-      double P3 = kine::PDK(W,M3,M4);
+      _P3 = kine::PDK(W,M3,M4);
 
       //PDK does not always have a valid solution for g*
       //Direct boost of g* into cm rest frame
       auto cmBoost=_CM->BoostToCM();
       auto p1cm=boost(*_p1,cmBoost);
-      auto P1=p1cm.P();
-    
+      _P1=p1cm.P();
   
-      double E1 = sqrt(M1*M1 + P1*P1);
-      double E3 = sqrt(M3*M3 + P3*P3);
+      double E1 = sqrt(M1*M1 + _P1*_P1);
+      double E3 = sqrt(M3*M3 + _P3*_P3);
      
-      /*auto prBoost=_p2->BoostToCM();
-      auto p2cm=boost(*_p2,prBoost);
-      p2cm=boost(p2cm,cmBoost);
-      std::cout<<"P1CM "<<p1cm.M2()<<" "<<p1cm.P2()<<" "<<p1cm.P()<<" "<<p1cm.E()<<" "<<std::endl;
-      std::cout<<"P2CM "<<p2cm.M2()<<" "<<p2cm.P2()<<" "<<p2cm.P()<<" "<<p2cm.E()<<" "<<std::endl;
-      std::cout<<" check "<<2*_p1->E()*M2<<" "<<_p1->M2()<<std::endl;
-      */
       //limits on t
-      double tmin =  M1*M1 + M3*M3  - 2 * ( E1*E3 -P1*P3 ); 
-      double tmax = tmin - 4*P1*P3 ;
-      _t = tmax*2; //start off >tmax
-      while( (_t=tmin - gRandom->Exp(1./_t_slope)) < tmax ){}; //tau=1/b0
+      _tmin =  M1*M1 + M3*M3  - 2 * ( E1*E3 -_P1*_P3 ); 
+      _tmax = _tmin - 4*_P1*_P3 ;
+    }
+   
+    double CosThFrom_t() const noexcept {
+      //exp(t_slope*(t-tmin)) truncated at tmax, inverse CDF
+      //tau=1/b0, fraction of the exponential above tmax
+      auto frac = -std::expm1(-_t_slope*(_tmin-_tmax));
+      _t = _tmin + std::log1p(-rng().Uniform()*frac)/_t_slope;
+      if(_t<_tmax) _t=_tmax;
       
-      return (1 - (tmin - _t)/2/P1/P3); //cos(theta) from t
+      return (1 - (_tmin - _t)/2/_P1/_P3); //cos(theta) from t
       
     }
     double CalcWeight() const{
-      double W = _CM->M();
-      double M1=_p1->M();
-      // double M1=0;
-      double M2=_p2->M();
-      double M3=_p3->M();
-      double M4=_p4->M();
-      
-      double P3 = kine::PDK(W,M3,M4);
-
-      //PDK does not always have a valid solution for g*
-      //Direct boost of g* into cm rest frame
-      auto cmBoost=_CM->BoostToCM();
-      auto p1cm=boost(*_p1,cmBoost);
-      auto P1=p1cm.P();
-      
-  
-      double E1 = sqrt(M1*M1 + P1*P1);
-      double E3 = sqrt(M3*M3 + P3*P3);
-      double tmin =  M1*M1 + M3*M3  - 2 * ( E1*E3 -P1*P3 ); 
-      return TMath::Exp( (_t-tmin) * _t_slope) * _t_strength + _s_strength;
+      return TMath::Exp( (_t-_tmin) * _t_slope) * _t_strength + _s_strength;
     }
     double CosThFrom_u() const noexcept {
        //Needs fixed to return correct cos theta and applu u distribution
@@ -121,7 +101,7 @@ namespace elSpectro{
       double umin = umax + 4*P1*P4 ;
       std::cout<<"umin "<<umin<<" "<<umax<<std::endl;
       double u = umax*2; //start off >tmax
-      while( (u=umin - gRandom->Exp(1./_u_slope)) < umax ){}; //tau=1/b0
+      while( (u=umin - rng().Exp(1./_u_slope)) < umax ){}; //tau=1/b0
       //u = -0.1;
  
       //weight is value/max_value as for Distribution
@@ -138,21 +118,8 @@ namespace elSpectro{
       //weight is value/max_value as for Distribution
       //here max value =1
       // _weight *=_s_strength;
-      double costh= gRandom->Uniform(-1,1);
-      double W = _CM->M();
-      double M1=_p1->M();
-      double M2=_p2->M();
-      double M3=_p3->M();
-      double M4=_p4->M();
-      
-      //PDK does not always have a valid solution for g*
-      //Direct boost of g* into cm rest frame
-      auto cmBoost=_CM->BoostToCM();
-      auto p1cm=boost(*_p1,cmBoost);
-      auto P1=p1cm.P();
-    
-  
-      _t=kine::tFromcosthWP1P3(costh, P1, kine::PDK(W,M3,M4), W,M1,M2,M3,M4);
+      double costh= rng().Uniform(-1,1);
+      _t=_tmin - 2*_P1*_P3*(1-costh);
     
       return  costh;
     }
@@ -168,6 +135,10 @@ namespace elSpectro{
     double _u_slope={0};
 
     mutable double _t;
+    mutable double _P1={0};//CM momenta
+    mutable double _P3={0};
+    mutable double _tmin={0};
+    mutable double _tmax={0};
   
     LorentzVector* _p1={nullptr};
     LorentzVector* _p2={nullptr};
@@ -0,0 +1,59 @@
+#include "UnweightingWriter.h"
+#include "ThreadRandom.h"
+#include <iostream>
+
+namespace elSpectro{
+
+  ///Constructor, maxWeight is the weight kept with probability 1
+  UnweightingWriter::UnweightingWriter(Writer* writer,double maxWeight):
+    _writer{writer},
+    _maxWeight{maxWeight}
+  {
+    if(_writer.get()==nullptr){
+      std::cerr<<"UnweightingWriter::UnweightingWriter no writer given, exiting..."<<std::endl;
+      exit(0);
+    }
+    if(_maxWeight<=0){
+      std::cerr<<"UnweightingWriter::UnweightingWriter max weight must be positive, exiting..."<<std::endl;
+      exit(0);
+    }
+    _filename=_writer->FileName();
+  }
+
+  UnweightingWriter::~UnweightingWriter(){
+    End();
+  }
+  ///////////////////////////////////////////////////////////////
+  ///Keep the event with probability weight/max
+  void UnweightingWriter::FillAnEvent(const EventRecord& event){
+    ++_nIn;
+    auto ratio=event.Weight()/_maxWeight;
+    if(event.Weight()>_maxSeen) _maxSeen=event.Weight();
+    if(ratio<=0) return;
+    if(ratio<1 && rng().Uniform()>ratio) return;
+
+    _event=event; //vectors keep their capacity
+    if(ratio>1){
+      _event.SetWeight(ratio);
+      ++_nExceeded;
+    }
+    else _event.SetWeight(1);
+    _writer->FillAnEvent(_event);
+    ++_nOut;
+  }
+  ///////////////////////////////////////////////////////////////
+  void UnweightingWriter::End(){
+    if(_ended) return;
+    _ended=true;
+    _writer->End();
+    std::cout<<"UnweightingWriter::End wrote "<<_nOut<<" of "<<_nIn<<" events, largest weight "<<_maxSeen<<" for max "<<_maxWeight<<std::endl;
+    if(_nExceeded)
+      std::cout<<"\t "<<_nExceeded<<" events above max written with weight/max, increase max for a fully unweighted sample"<<std::endl;
+  }
+  ///////////////////////////////////////////////////////////////
+  void UnweightingWriter::OpenShard(int ishard){
+    _writer->OpenShard(ishard);
+    _filename=_writer->FileName();
+  }
+
+}
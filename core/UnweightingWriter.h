@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		UnweightingWriter
+///Description:
+///             Unweight weighted events before any Writer
+///             Each event is passed on with probability weight/max
+///             and written with weight 1, see Manager::SetWeightedEvents
+///             Events with weight > max are passed on with weight/max
+///             and counted, so the sample stays unbiased
+///             Default max 1 is the envelope of all accept/reject nodes
+///             e.g. writer(new UnweightingWriter{new HepMC3Writer{"out.txt"}});
+///             or around an AsyncWriter so unweighting stays on the
+///             generator thread
+
+#pragma once
+
+#include "Writer.h"
+#include <memory>
+
+namespace elSpectro{
+
+  class UnweightingWriter : public Writer {
+
+   public:
+     //takes ownership of writer
+     UnweightingWriter(Writer* writer,double maxWeight=1);
+     ~UnweightingWriter() final;
+     UnweightingWriter(const UnweightingWriter& other)=delete;
+     UnweightingWriter(UnweightingWriter&&)=delete;
+     UnweightingWriter& operator=(const UnweightingWriter& other)=delete;
+     UnweightingWriter& operator=(UnweightingWriter&& other)=delete;
+
+     void WriteHeader() final{};
+     using Writer::FillAnEvent;
+     void FillAnEvent(const EventRecord& event) final;
+     void Write() final{_writer->Write();}
+     void End() final;
+     void Init() final{_writer->Init();}
+
+     void Flush() final{_writer->Flush();}
+     void OpenShard(int ishard) final;
+
+     void MergeShards(const std::vector<std::string>& shards,
+		      const std::string& merged) const final{
+       _writer->MergeShards(shards,merged);
+     }
+
+     const Writer* GetWriter()const noexcept{return _writer.get();}
+     long NIn()const noexcept{return _nIn;}
+     long NOut()const noexcept{return _nOut;}
+     //events written with weight > 1
+     long NExceeded()const noexcept{return _nExceeded;}
+     double MaxWeightSeen()const noexcept{return _maxSeen;}
+
+   private:
+
+     std::unique_ptr<Writer> _writer;
+     EventRecord _event;//! reused copy of accepted events
+     double _maxWeight={1};
+     double _maxSeen={0};
+     long _nIn={0};
+     long _nOut={0};
+     long _nExceeded={0};
+     bool _ended={false};//!
+
+     ClassDef(elSpectro::UnweightingWriter,1); //class UnweightingWriter
+   };
+
+
+}
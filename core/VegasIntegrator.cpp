@@ -0,0 +1,220 @@
+#include "VegasIntegrator.h"
+#include "ThreadRandom.h"
+#include "FunctionsForThreads.h"
+#include <algorithm>
+#include <iostream>
+
+namespace elSpectro{
+
+  namespace{
+    //points of an iteration are split into this many chunks whatever
+    //the number of threads, so results are reproducible
+    constexpr int NChunks=64;
+  }
+
+  ///////////////////////////////////////////////////////////
+  VegasIntegrator::VegasIntegrator(const std::vector<double>& lower,const std::vector<double>& upper,int nbins):
+    _lower{lower},
+    _upper{upper},
+    _ndim(lower.size()),
+    _nbins{nbins}
+  {
+    if(_lower.size()!=_upper.size() || _ndim==0 || _nbins<1){
+      std::cerr<<"VegasIntegrator::VegasIntegrator need lower and upper limits in each dimension and at least 1 bin, exiting..."<<std::endl;
+      exit(0);
+    }
+    //start from uniform bins
+    _edges.resize(_ndim);
+    for(auto& edges:_edges){
+      edges.resize(_nbins+1);
+      for(int ib=0;ib<=_nbins;++ib) edges[ib]=static_cast<double>(ib)/_nbins;
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  ///First iteration only trains the grid, then iterate until
+  ///the requested precision or the maximum number of iterations
+  double VegasIntegrator::Integrate(){
+    if(!_func){
+      std::cerr<<"VegasIntegrator::Integrate no function given, exiting..."<<std::endl;
+      exit(0);
+    }
+    if(_seed==0) _seed=PhiloxEngine{0}.GetSeed();
+
+    if(_nIterations==0){
+      Iterate(true);
+      ResetSums();
+    }
+    for(int it=0;it<_maxIterations;++it){
+      Iterate(true);
+      if(_error==0 || (it>0 && RelativeError()<_precision)) break;
+    }
+
+    std::cout<<"VegasIntegrator::Integrate() "<<_integral<<" +- "<<_error<<" ( "<<RelativeError()*100<<"% ) from "<<_nCallsTotal<<" calls in "<<_nIterations<<" iterations, chi2/dof "<<Chi2PerDof()<<std::endl;
+    if(RelativeError()>_precision)
+      std::cout<<"VegasIntegrator::Integrate() warning requested precision "<<_precision<<" not reached"<<std::endl;
+    return _integral;
+  }
+  ///////////////////////////////////////////////////////////
+  double VegasIntegrator::Refine(int niterations){
+    if(_seed==0) _seed=PhiloxEngine{0}.GetSeed();
+    for(int it=0;it<niterations;++it)
+      Iterate(false);
+    return _integral;
+  }
+  ///////////////////////////////////////////////////////////
+  void VegasIntegrator::ResetSums(){
+    _sumWeights=0;
+    _sumWeightedI=0;
+    _sumWeightedI2=0;
+    _nResults=0;
+  }
+  ///////////////////////////////////////////////////////////
+  double VegasIntegrator::Chi2PerDof()const noexcept{
+    if(_nResults<2 || _sumWeights==0) return 0;
+    auto chi2=_sumWeightedI2-_sumWeightedI*_sumWeightedI/_sumWeights;
+    return chi2/(_nResults-1);
+  }
+  ///////////////////////////////////////////////////////////
+  double VegasIntegrator::SampleWith(RandomEngine& random,double* x,int* bins) const{
+    double weight=1;
+    for(int id=0;id<_ndim;++id){
+      auto u=random.Uniform()*_nbins;
+      int ib=std::min(static_cast<int>(u),_nbins-1);
+      const auto& edges=_edges[id];
+      auto width=edges[ib+1]-edges[ib];
+      auto range=_upper[id]-_lower[id];
+      x[id]=_lower[id]+range*(edges[ib]+(u-ib)*width);
+      weight*=width*_nbins*range;
+      if(bins) bins[id]=ib;
+    }
+    return weight;
+  }
+  ///////////////////////////////////////////////////////////
+  double VegasIntegrator::Sample(double* x) const{
+    return SampleWith(rng(),x,nullptr);
+  }
+  ///////////////////////////////////////////////////////////
+  double VegasIntegrator::Density(const double* x) const{
+    double density=1;
+    for(int id=0;id<_ndim;++id){
+      auto range=_upper[id]-_lower[id];
+      auto u=(x[id]-_lower[id])/range;
+      if(u<0 || u>1) return 0;
+      const auto& edges=_edges[id];
+      int ib=std::upper_bound(edges.begin(),edges.end(),u)-edges.begin()-1;
+      ib=std::min(std::max(ib,0),_nbins-1);
+      density/=(edges[ib+1]-edges[ib])*_nbins*range;
+    }
+    return density;
+  }
+  ///////////////////////////////////////////////////////////
+  ///One iteration of _nCalls points, chunks may run on different threads
+  void VegasIntegrator::Iterate(bool adapt){
+    const long callsPerChunk=std::max(2L,_nCalls/NChunks);
+    const long ncalls=callsPerChunk*NChunks;
+
+    std::vector<double> sum(NChunks,0);
+    std::vector<double> sum2(NChunks,0);
+    //(f*weight)^2 in each bin of each dimension, for adapting grid
+    std::vector<std::vector<double>> binSums(NChunks);
+
+    auto chunk=[&](int ich){
+      PhiloxEngine random{_seed,static_cast<uint64_t>(_nIterations)*NChunks+ich};
+      std::vector<double> x(_ndim);
+      std::vector<int> bins(_ndim);
+      auto& chunkBins=binSums[ich];
+      if(adapt) chunkBins.assign(_ndim*_nbins,0);
+      for(long ic=0;ic<callsPerChunk;++ic){
+	auto weight=SampleWith(random,x.data(),bins.data());
+	auto fw=_func(x.data())*weight;
+	if(std::isnan(fw)) fw=0;
+	sum[ich]+=fw;
+	sum2[ich]+=fw*fw;
+	if(adapt)
+	  for(int id=0;id<_ndim;++id) chunkBins[id*_nbins+bins[id]]+=fw*fw;
+      }
+    };
+    threads::parallelFor(NChunks,chunk,_concurrent);
+
+    //combine chunks in order so the result is reproducible
+    double isum=0;
+    double isum2=0;
+    for(int ich=0;ich<NChunks;++ich){
+      isum+=sum[ich];
+      isum2+=sum2[ich];
+    }
+    auto iterIntegral=isum/ncalls;
+    auto iterVariance=(isum2/ncalls-iterIntegral*iterIntegral)/(ncalls-1);
+
+    ++_nIterations;
+    _nCallsTotal+=ncalls;
+    if(iterVariance<=0){ //e.g. constant function, exact
+      ResetSums();
+      _integral=iterIntegral;
+      _error=0;
+    }
+    else{
+      auto w=1./iterVariance;
+      _sumWeights+=w;
+      _sumWeightedI+=w*iterIntegral;
+      _sumWeightedI2+=w*iterIntegral*iterIntegral;
+      ++_nResults;
+      _integral=_sumWeightedI/_sumWeights;
+      _error=1./std::sqrt(_sumWeights);
+    }
+
+    if(adapt){
+      std::vector<double> total(_ndim*_nbins,0);
+      for(const auto& chunkBins:binSums)
+	for(size_t ib=0;ib<total.size();++ib) total[ib]+=chunkBins[ib];
+      Adapt(total);
+    }
+  }
+  ///////////////////////////////////////////////////////////
+  ///Move edges so each bin would have had an equal share of
+  ///the smoothed and damped (f*weight)^2
+  void VegasIntegrator::Adapt(const std::vector<double>& binSums){
+    std::vector<double> d(_nbins);
+    std::vector<double> r(_nbins);
+    std::vector<double> newEdges(_nbins+1);
+
+    for(int id=0;id<_ndim;++id){
+      const double* dim=&binSums[id*_nbins];
+      //smooth with neighbours
+      double dsum=0;
+      for(int ib=0;ib<_nbins;++ib){
+	double val=dim[ib];
+	int n=1;
+	if(ib>0){val+=dim[ib-1];++n;}
+	if(ib<_nbins-1){val+=dim[ib+1];++n;}
+	d[ib]=val/n;
+	dsum+=d[ib];
+      }
+      if(dsum<=0) continue; //nothing seen in this dimension
+
+      double rsum=0;
+      for(int ib=0;ib<_nbins;++ib){
+	r[ib]=0;
+	auto frac=d[ib]/dsum;
+	if(frac>0 && frac<1) r[ib]=std::pow((frac-1)/std::log(frac),_alpha);
+	else if(frac>=1) r[ib]=1;
+	rsum+=r[ib];
+      }
+
+      auto& edges=_edges[id];
+      double delta=rsum/_nbins;
+      double acc=0;
+      int jb=0;
+      newEdges[0]=0;
+      for(int ib=1;ib<_nbins;++ib){
+	double need=delta*ib;
+	while(jb<_nbins-1 && acc+r[jb]<need){acc+=r[jb];++jb;}
+	double frac= r[jb]>0 ? std::min(1.,(need-acc)/r[jb]) : 0;
+	newEdges[ib]=edges[jb]+frac*(edges[jb+1]-edges[jb]);
+      }
+      newEdges[_nbins]=1;
+      edges=newEdges;
+    }
+  }
+
+}
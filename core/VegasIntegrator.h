@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////
+///
+///Class:		VegasIntegrator
+///Description:
+///             Adaptive Monte Carlo integration (Lepage, VEGAS)
+///             Each dimension has a grid of bins of equal probability
+///             which is moved towards where the integrand is largest,
+///             so points are importance sampled from the product of
+///             the 1D grids. Iterations are combined with weights
+///             1/variance and stop at the requested relative error.
+///             Points of an iteration are shared between threads in
+///             fixed chunks, each with its own random stream, so the
+///             result does not depend on the number of threads
+///             The trained grid can be reused as a proposal density
+///             via Sample(x) which returns the weight of x
+///             e.g.
+///             VegasIntegrator vegas({0,-1},{1,1});
+///             vegas.SetFunction([](const double* x){...});
+///             vegas.SetPrecision(0.005);
+///             auto integral = vegas.Integrate();
+///             auto error = vegas.Error();
+#pragma once
+
+#include "RandomEngine.h"
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace elSpectro{
+
+  class VegasIntegrator{
+
+  public:
+
+    using function_t = std::function<double(const double*)>;
+
+    VegasIntegrator(const std::vector<double>& lower,const std::vector<double>& upper,int nbins=50);
+
+    //concurrent=false if f must stay on the calling thread
+    void SetFunction(function_t f,bool concurrent=true){
+      _func=f;
+      _concurrent=concurrent;
+    }
+    //stop when Error()/Integral() is below this
+    void SetPrecision(double relerr){_precision=relerr;}
+    void SetMaxIterations(int n){_maxIterations=n;}
+    void SetCallsPerIteration(long n){_nCalls=n;}
+    void SetSeed(uint64_t seed){_seed=seed;}
+
+    //adapts and integrates, calling again continues with the trained grid
+    double Integrate();
+    //run more iterations but keep the grid fixed
+    double Refine(int niterations);
+
+    double Integral()const noexcept{return _integral;}
+    double Error()const noexcept{return _error;}
+    double RelativeError()const noexcept{return _integral!=0 ? _error/std::abs(_integral) : 0;}
+    //consistency of the iterations, should be ~1
+    double Chi2PerDof()const noexcept;
+    long NCalls()const noexcept{return _nCallsTotal;}
+    int NIterations()const noexcept{return _nIterations;}
+
+    //draw x from the trained grid with rng(), returns 1/density
+    //so f(x)*weight averages to the integral
+    double Sample(double* x) const;
+    double Density(const double* x) const;
+
+    int NDim()const noexcept{return _ndim;}
+    const std::vector<double>& Edges(int idim)const{return _edges[idim];}
+
+  private:
+
+    void Iterate(bool adapt);
+    void Adapt(const std::vector<double>& binSums);
+    void ResetSums();
+    double SampleWith(RandomEngine& random,double* x,int* bins) const;
+
+    function_t _func;//!
+    std::vector<double> _lower;
+    std::vector<double> _upper;
+    //bin edges in units of the range, 0 to 1
+    std::vector<std::vector<double>> _edges;
+
+    double _integral={0};
+    double _error={0};
+    double _sumWeights={0};
+    double _sumWeightedI={0};
+    double _sumWeightedI2={0};
+
+    double _precision={1E-3};
+    double _alpha={1.5}; //grid damping, smaller adapts more slowly
+    long _nCalls={20000};
+    long _nCallsTotal={0};
+    uint64_t _seed={0};
+    int _ndim={0};
+    int _nbins={50};
+    int _maxIterations={30};
+    int _nIterations={0};
+    int _nResults={0}; //iterations in the weighted average
+    bool _concurrent={true};
+
+  };
+
+}//namespace elSpectro
@@ -1,23 +1,77 @@
 #include "Writer.h"
 #include "Manager.h"
+#include <fstream>
+#include <iostream>
 
 namespace elSpectro{
 
+  ///Constructor to create ouput file
+  Writer::Writer(const std::string& filename):
+    _filename(filename),
+    _file(filename)
+  {
+    if(!_file.is_open()){
+      std::cerr<<"Writer::Writer file "<<filename<<" cannot be opened, exiting..."<<std::endl;
+      exit(0);
+    }
+  }
+  
   void Writer::Init(){
     
-     //get copies of the particle pointers
- 
-    auto& sptrs=Manager::Instance().Particles().StableParticles();
-    for(const auto* p:sptrs){
-      _finalParticles.push_back(p);
-     }
-
-    
+     //get copies of the initial particle pointers
+     //for format specific information e.g. which is the beam
     auto& iptrs=Manager::Instance().Reaction()->InitialParticles();
     for(const auto* p:iptrs)
       _initialParticles.push_back(p);
-
-    _vertices = (&(Manager::Instance().GetVertices()));
    
   }
+  /////////////////////////////////////////////////////////
+  void Writer::FillAnEvent(){
+    FillAnEvent(Manager::Instance().CurrentEvent());
+  }
+  /////////////////////////////////////////////////////////
+  void Writer::Write(){
+    //write stream, note an empty rdbuf would set failbit on _file
+    if(_stream.rdbuf()->in_avail()>0) _file<<_stream.rdbuf();
+    //reset stream
+    _stream.str("");
+    _stream.clear();
+  }
+  /////////////////////////////////////////////////////////
+  ///Note Flush() before forking so the shard file is the only
+  ///one this process writes to
+  void Writer::OpenShard(int ishard){
+    _file.close();
+    _filename=ShardFileName(_filename,ishard);
+    _file.open(_filename);
+    if(!_file.is_open()){
+      std::cerr<<"Writer::OpenShard file "<<_filename<<" cannot be opened, exiting..."<<std::endl;
+      exit(0);
+    }
+    WriteHeader();
+    Write();
+  }
+  /////////////////////////////////////////////////////////
+  void Writer::MergeShards(const std::vector<std::string>& shards,
+			   const std::string& merged) const{
+    std::ofstream out(merged);
+    if(!out.is_open()){
+      std::cerr<<"Writer::MergeShards file "<<merged<<" cannot be opened, exiting..."<<std::endl;
+      exit(0);
+    }
+    for(const auto& shard:shards){
+      std::ifstream in(shard);
+      if(in.peek()==std::ifstream::traits_type::eof()) continue;//empty shard
+      out<<in.rdbuf();
+    }
+  }
+  /////////////////////////////////////////////////////////
+  std::string Writer::ShardFileName(const std::string& filename,int ishard){
+    auto tag=std::string("__shard")+std::to_string(ishard);
+    auto dot=filename.find_last_of('.');
+    auto slash=filename.find_last_of('/');
+    if(dot==std::string::npos || (slash!=std::string::npos && dot<slash) )
+      return filename+tag;
+    return filename.substr(0,dot)+tag+filename.substr(dot);
+  }
 }
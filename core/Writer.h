@@ -3,12 +3,20 @@
 ///Class:		Writer
 ///Description:
 ///             Interface to different output formats
+///             Derived classes format the EventRecord of each event
+///             via FillAnEvent(const EventRecord&), FillAnEvent()
+///             uses Manager::CurrentEvent()
 
 
 #pragma once
 #include "ParticleManager.h"
+#include "EventRecord.h"
 
 #include <TObject.h> //for ClassDef
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace elSpectro{
   
@@ -18,6 +26,7 @@ namespace elSpectro{
   public:
 
     Writer()=default;
+    Writer(const std::string& filename);
     virtual ~Writer()=default;
     Writer(const Writer& other); //need the virtual destructor...so rule of 5
     Writer(Writer&&)=default;
@@ -28,16 +37,34 @@ namespace elSpectro{
     
     virtual void Init();
     virtual void WriteHeader()=0;
-    virtual void FillAnEvent()=0;
-    virtual void Write()=0;
+    virtual void FillAnEvent();
+    virtual void FillAnEvent(const EventRecord& event)=0;
+    virtual void Write();
     virtual void End()=0;
 
+    //write anything buffered e.g. before forking processes
+    virtual void Flush(){Write();_file.flush();}
+    //continue writing in ShardFileName(FileName(),ishard)
+    virtual void OpenShard(int ishard);
+
+    const std::string& FileName()const noexcept{return _filename;}
+    
+    //combine files written by parallel event loops into merged
+    //default is to just append them, formats with headers override
+    virtual void MergeShards(const std::vector<std::string>& shards,
+			     const std::string& merged) const;
+    
+    //e.g. out.dat => out__shard2.dat
+    static std::string ShardFileName(const std::string& filename,int ishard);
+    
 
   protected :
     
     particle_constptrs _initialParticles;
-    particle_constptrs _finalParticles;
-    std::vector<const LorentzVector*>* _vertices={nullptr};
+    std::string _filename;
+    
+    std::ofstream _file; //! output file
+    std::stringstream _stream;
      
     ClassDef(elSpectro::Writer,1); //class Writer
     
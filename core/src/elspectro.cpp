@@ -3,6 +3,8 @@
 #include <TEnv.h>
 #include <TString.h>
 #include <TSystem.h>
+#include <TPRegexp.h>
+#include <vector>
 
 
 int main(int argc, char **argv) {
@@ -11,15 +13,61 @@ int main(int argc, char **argv) {
   //get command line options first check if makeall
   TString macroName;
   bool isInteractive=false;
+  TString cacheDir;
+  int nJobs=1;
+  //options ROOT should not see, it would cd into an existing
+  //cache directory and try to open the number of jobs as a file
+  std::vector<char*> rootArgv;
   for(Int_t i=0;i<argc;i++){
     TString opt=argv[i];
-    if((opt.Contains(".C"))) macroName=opt;
+    if(opt==TString("--cache") && i+1<argc){ cacheDir=argv[++i]; continue;}
+    else if(opt.BeginsWith("--cache=")){ cacheDir=opt(8,opt.Length()); continue;}
+    else if((opt.Contains(".C"))) macroName=opt;
     else if(opt==TString("--i")) isInteractive=true;
+    else if(opt==TString("--jobs") && i+1<argc){ nJobs=TString(argv[++i]).Atoi(); continue;}
+    else if(opt.BeginsWith("--jobs=")){ nJobs=TString(opt(7,opt.Length())).Atoi(); continue;}
+    rootArgv.push_back(argv[i]);
+  }
+  int rootArgc=rootArgv.size();
+  rootArgv.push_back(nullptr);
+
+  //macro.C+g("arg",1) => macro.C, with an absolute path so it
+  //is found whatever the working directory
+  //the cache key uses the invocation as given, not where it runs
+  const TString macroCall=macroName;
+  TString macroFile=macroName;
+  auto iargs=macroFile.First('(');
+  if(iargs!=kNPOS) macroFile.Remove(iargs);
+  TPRegexp("\\+\\+?[gO]?$").Substitute(macroFile,"");
+  gSystem->ExpandPathName(macroFile);
+  if(macroFile.Length() && gSystem->IsAbsoluteFileName(macroFile)==kFALSE){
+    TString cwd=gSystem->WorkingDirectory();
+    macroFile=cwd+"/"+macroFile;
+    macroName=cwd+"/"+macroName;
+  }
+  if(cacheDir.Length()){
+    gSystem->ExpandPathName(cacheDir);
+    if(gSystem->IsAbsoluteFileName(cacheDir)==kFALSE)
+      cacheDir=TString(gSystem->WorkingDirectory())+"/"+cacheDir;
   }
   
-  TRint  *app = new TRint("elSpectro", &argc, argv);
+  TRint  *app = new TRint("elSpectro", &rootArgc, rootArgv.data());
   // Run the TApplication (not needed if you only want to store the histograms.)
   app->ProcessLine(".x $ELSPECTRO/core/src/Load.C");
+  //fork workers when the macro event loop starts
+  if(nJobs>1) app->ProcessLine(Form("elSpectro::Manager::Instance().SetJobs(%d);",nJobs));
+  //reuse initialisation results of earlier runs of this macro
+  //the key uses the macro file and the full invocation with its arguments
+  if(cacheDir.Length()&&macroName.Length()){
+    //escaped for a C++ string literal in ProcessLine
+    auto quoted=[](TString str){
+      str.ReplaceAll("\\","\\\\");
+      str.ReplaceAll("\"","\\\"");
+      return str;
+    };
+    app->ProcessLine(Form("elSpectro::Manager::Instance().Cache().SetDirectory(\"%s\");",quoted(cacheDir).Data()));
+    app->ProcessLine(Form("elSpectro::Manager::Instance().Cache().SetConfigurationFile(\"%s\",\"%s\");",quoted(macroFile).Data(),quoted(macroCall).Data()));
+  }
 
 
 